@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include "positions.h"
+#include "bitboard.h"
+
+using namespace athena;
+
+static void BM_BitBoardLogic(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    auto a = pos.board.everyone();
+    auto b = pos.board.occ(Pawn);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        auto c = (a & ~b) | (a ^ b);
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_BitBoardLogic)->Apply(positionArgs);
+
+static void BM_BitBoardShift(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    auto pawns = pos.board.occ(Pawn);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(pawns);
+        for (auto shift : PUSH_DELTA)
+            benchmark::DoNotOptimize(pawns.shift(shift));
+    }
+}
+BENCHMARK(BM_BitBoardShift)->Apply(positionArgs);
+
+static void BM_BitBoardPopCount(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    auto occupied = pos.board.everyone();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(occupied);
+        benchmark::DoNotOptimize(occupied.popCount());
+    }
+}
+BENCHMARK(BM_BitBoardPopCount)->Apply(positionArgs);
+
+static void BM_BitBoardPopLSB(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    auto occupied = pos.board.everyone();
+
+    for (auto _ : state)
+    {
+        auto bb = occupied;
+        benchmark::DoNotOptimize(bb);
+        while (bb) benchmark::DoNotOptimize(bb.popLSB());
+    }
+    state.SetItemsProcessed(state.iterations() * occupied.popCount());
+}
+BENCHMARK(BM_BitBoardPopLSB)->Apply(positionArgs);
+
+static void BM_BitBoardIterate(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    auto occupied = pos.board.everyone();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(occupied);
+        for (auto sq : occupied) benchmark::DoNotOptimize(sq);
+    }
+    state.SetItemsProcessed(state.iterations() * occupied.popCount());
+}
+BENCHMARK(BM_BitBoardIterate)->Apply(positionArgs);
+
+// Every slider of the position against every square it could reach
+static void BM_Between(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    auto sliders = pos.board.occ(Rook, Queen);
+    int64_t pairs = 0;
+
+    for (auto _ : state)
+    {
+        for (auto source : sliders)
+            for (auto target : PIECE_ATTACK[Rook][source])
+                benchmark::DoNotOptimize(between(source, target, Rook));
+    }
+
+    for (auto source : sliders) pairs += PIECE_ATTACK[Rook][source].popCount();
+    state.SetItemsProcessed(state.iterations() * pairs);
+}
+BENCHMARK(BM_Between)->Apply(positionArgs);
@@ -0,0 +1,152 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <sstream>
+#include "positions.h"
+#include "movegen.h"
+#include "eval.h"
+#include "nnue/nnue.h"
+
+using namespace athena;
+
+static void BM_Evaluate(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(evaluate(pos));
+}
+BENCHMARK(BM_Evaluate)->Apply(positionArgs);
+
+static void BM_Material(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(material(pos));
+}
+BENCHMARK(BM_Material)->Apply(positionArgs);
+
+// Random weights, the timings do not depend on their values
+template <typename Layer>
+static void randomize(Layer& layer)
+{
+    std::mt19937 rng(2025);
+    std::uniform_int_distribution<int32_t> dist(-64, 64);
+
+    std::vector<int32_t> params(Layer::Parameters);
+    for (auto& p : params) p = dist(rng);
+
+    std::stringstream stream(std::string(reinterpret_cast<const char*>(params.data()), params.size() * sizeof(int32_t)));
+    layer.read(stream);
+}
+
+// Full evaluation from scratch: the first layer over every active feature
+// and the rest of the network on top
+template <typename Arch>
+static void BM_ModelRefresh(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    auto model = std::make_unique<Model<Arch>>();
+    randomize(*model);
+
+    for (auto _ : state)
+    {
+        model->reset();
+        benchmark::DoNotOptimize(model->evaluate(pos));
+    }
+}
+BENCHMARK(BM_ModelRefresh<Arch128>)->Apply(positionArgs);
+BENCHMARK(BM_ModelRefresh<Arch512x16>)->Apply(positionArgs);
+BENCHMARK(BM_ModelRefresh<Arch256x32x32>)->Apply(positionArgs);
+
+// One move made on a computed accumulator, as the search evaluates children
+template <typename Arch>
+static void BM_ModelIncremental(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    auto model = std::make_unique<Model<Arch>>();
+    randomize(*model);
+
+    Move moves[MAX_MOVES];
+    int size = genAllQuietMoves(pos, moves);
+
+    model->reset();
+    model->evaluate(pos);
+
+    int i = 0;
+    for (auto _ : state)
+    {
+        pos.makemove(moves[i]);
+        model->push();
+        benchmark::DoNotOptimize(model->evaluate(pos));
+        model->pop();
+        pos.undomove(moves[i]);
+        i = (i + 1) % size;
+    }
+}
+BENCHMARK(BM_ModelIncremental<Arch128>)->Apply(positionArgs);
+BENCHMARK(BM_ModelIncremental<Arch512x16>)->Apply(positionArgs);
+BENCHMARK(BM_ModelIncremental<Arch256x32x32>)->Apply(positionArgs);
+
+template <typename Layer>
+static void BM_LayerPropagate(benchmark::State& state)
+{
+    auto layer = std::make_unique<Layer>();
+    randomize(*layer);
+
+    // Activation output, about half the inputs are zero
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int32_t> dist(-127, 127);
+    alignas(CacheLineSize) int32_t input[Layer::InputSize];
+    alignas(CacheLineSize) int32_t output[Layer::OutputSize];
+    for (auto& x : input) x = std::max(0, dist(rng));
+
+    for (auto _ : state)
+    {
+        layer->propagate(input, output);
+        benchmark::DoNotOptimize(output);
+    }
+}
+BENCHMARK(BM_LayerPropagate<Dense<512, 16>>);
+BENCHMARK(BM_LayerPropagate<Dense<256, 32>>);
+BENCHMARK(BM_LayerPropagate<Dense<32, 32>>);
+
+template <typename Activation>
+static void BM_ActivationPropagate(benchmark::State& state)
+{
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int32_t> dist(-4096, 4096);
+    alignas(CacheLineSize) int32_t input[Activation::InputSize];
+    alignas(CacheLineSize) int32_t output[Activation::OutputSize];
+    for (auto& x : input) x = dist(rng);
+
+    Activation activation;
+    for (auto _ : state)
+    {
+        activation.propagate(input, output);
+        benchmark::DoNotOptimize(output);
+    }
+}
+BENCHMARK(BM_ActivationPropagate<ReLU<512>>);
+BENCHMARK(BM_ActivationPropagate<ClippedReLU<512>>);
+
+// The sparse first layer over the active features of a position
+static void BM_SparseDensePropagate(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    auto layer = std::make_unique<SparseDense<Lx0, 512>>();
+    randomize(*layer);
+
+    FeatureTransformer transformer;
+    int indices[BOARDSIZE];
+    int count = transformer.active(pos, indices);
+
+    alignas(CacheLineSize) int32_t output[512];
+    for (auto _ : state)
+    {
+        layer->propagate(indices, count, output);
+        benchmark::DoNotOptimize(output);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SparseDensePropagate)->Apply(positionArgs);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include "positions.h"
+#include "movegen.h"
+
+using namespace athena;
+
+static void BM_GenAllNoisyMoves(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    Move moves[MAX_MOVES];
+    int size = 0;
+
+    for (auto _ : state)
+    {
+        size = genAllNoisyMoves(pos, moves);
+        benchmark::DoNotOptimize(moves);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_GenAllNoisyMoves)->Apply(positionArgs);
+
+static void BM_GenAllQuietMoves(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    Move moves[MAX_MOVES];
+    int size = 0;
+
+    for (auto _ : state)
+    {
+        size = genAllQuietMoves(pos, moves);
+        benchmark::DoNotOptimize(moves);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_GenAllQuietMoves)->Apply(positionArgs);
+
+// Every playable square, from the side to move's point of view
+static void BM_IsSquareAttacked(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    auto turn = pos.states.back().turn;
+
+    for (auto _ : state)
+        for (auto sq : VALID_SQUARES)
+            benchmark::DoNotOptimize(isSquareAttacked(pos, sq, turn));
+
+    state.SetItemsProcessed(state.iterations() * std::size(VALID_SQUARES));
+}
+BENCHMARK(BM_IsSquareAttacked)->Apply(positionArgs);
+
+static void BM_IsLegal(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    Move moves[MAX_MOVES];
+    int size = 0;
+    size += genAllNoisyMoves(pos, moves + size);
+    size += genAllQuietMoves(pos, moves + size);
+
+    for (auto _ : state)
+        for (int i = 0; i < size; ++i)
+            benchmark::DoNotOptimize(isLegal(pos, moves[i]));
+
+    state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_IsLegal)->Apply(positionArgs);
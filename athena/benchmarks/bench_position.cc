@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include "positions.h"
+#include "movegen.h"
+
+using namespace athena;
+
+// Every pseudo-legal move of the position made and taken back once
+template <typename Policy>
+static void BM_MakeUndo(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    Move moves[MAX_MOVES];
+    int size = 0;
+    size += genAllNoisyMoves(pos, moves + size);
+    size += genAllQuietMoves(pos, moves + size);
+
+    Policy walk;
+    for (auto _ : state)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            walk.make(pos, moves[i]);
+            benchmark::ClobberMemory();
+            walk.undo(pos, moves[i]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_MakeUndo<MakeUnmake>)->Apply(positionArgs);
+BENCHMARK(BM_MakeUndo<CopyMake>)->Apply(positionArgs);
+
+static void BM_FenParse(benchmark::State& state)
+{
+    Position pos;
+    const char* fen = BENCH_FENS[state.range(0)];
+
+    for (auto _ : state)
+    {
+        fromString(fen, pos);
+        benchmark::DoNotOptimize(pos);
+    }
+    state.SetBytesProcessed(state.iterations() * std::strlen(fen));
+}
+BENCHMARK(BM_FenParse)->Apply(positionArgs);
+
+static void BM_FenPrint(benchmark::State& state)
+{
+    auto pos = benchPosition(state);
+    char buffer[MAX_FEN_LENGTH];
+    int64_t length = 0;
+
+    for (auto _ : state)
+    {
+        length = toString(pos, buffer) - buffer;
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_FenPrint)->Apply(positionArgs);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include "utility.h"
+
+namespace athena
+{
+
+// Opening, middlegame and endgame, picked by a benchmark's range(0)
+constexpr const char* BENCH_FENS[] =
+{
+    "classic r 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bq,bp,10,gp,gk,bk,bp,10,gp,gq,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr",
+    "modern r 0 1010 1010 -,-,-,- rr,3,rk,1,rn,rr,rp,1,rp,1,rb,rp,rp,8,rp,br,2,bp,1,rn,rp,5,gp,gr,bn,1,bp,9,gp,gn,1,bp,10,gp,4,bp,6,gp,gk,3,bk,9,gn,3,bp,10,gp,gb,2,bp,2,yp,8,br,bp,10,gp,gr,yn,5,yp,1,bn,yp,2,yp,yp,1,yp,yr,1,yb,yk,2,yn,yr",
+    "modern g 0 0000 0000 -,-,-,- 6,rr,3,bb,12,rk,2,rp,5,rp,1,rp,1,gp,gr,2,rr,14,bp,11,bp,13,bk,8,gn,4,bp,bn,7,gp,2,gk,1,bp,11,gn,3,yp,3,yk,3,gp,6,yp,4,yp,3,yp,1,yp,5,yr,1,yr",
+};
+
+inline Position benchPosition(const benchmark::State& state)
+{
+    Position pos;
+    fromString(BENCH_FENS[state.range(0)], pos);
+    return pos;
+}
+
+// Registers a benchmark once per position
+inline void positionArgs(benchmark::internal::Benchmark* bench)
+{
+    bench->DenseRange(0, std::size(BENCH_FENS) - 1)->ArgName("position");
+}
+
+} // namespace athena
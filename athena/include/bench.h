@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+namespace athena
+{
+
+// Searches a fixed set of 50 Classic and Modern positions to `depth` with the
+// classical evaluation, positions spread over `threads`, and writes per
+// position and total node counts with the nps. Returns the total, a
+// signature that only changes when the search or evaluation does.
+uint64_t runBench(std::ostream& output, int depth, int threads = 1);
+
+} // namespace athena
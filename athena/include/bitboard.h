@@ -178,25 +178,35 @@ class BitBoard
 };
 
 // === Iterator class ===
+// Walks one 64-bit chunk at a time so each step is a ctz and a blsr on a
+// register instead of rescanning all four chunks.
 class BitBoard::Iterator {
 private:
     BitBoard bb;
+    int chunk;
+    uint64_t bits;
+
+    void seek() {
+        while (!bits && ++chunk < 4) bits = bb.chunks[chunk];
+    }
 
 public:
-    explicit Iterator(BitBoard b) : bb(b) {}
+    explicit Iterator(BitBoard b, int c = 0) : bb(b), chunk(c), bits(c < 4 ? b.chunks[c] : 0) {
+        if (c < 4) seek();
+    }
 
     Square operator*() const {
-        BitBoard temp = bb;
-        return temp.popLSB();
+        return static_cast<Square>((chunk << 6) + __builtin_ctzll(bits));
     }
 
     Iterator& operator++() {
-        bb.popLSB();
+        bits &= bits - 1;
+        seek();
         return *this;
     }
 
     bool operator!=(const Iterator& other) const {
-        return static_cast<bool>(bb) != static_cast<bool>(other.bb);
+        return chunk != other.chunk;
     }
 };
 
@@ -206,7 +216,7 @@ inline BitBoard::Iterator BitBoard::begin() const {
 }
 
 inline BitBoard::Iterator BitBoard::end() const {
-    return Iterator(BitBoard());
+    return Iterator(BitBoard(), 4);
 }
 
 // Choosing alias
@@ -351,9 +361,6 @@ inline auto between(Square a, Square b, Piece piece) noexcept
     return betweenMask & PIECE_ATTACK[piece][a] & PIECE_ATTACK[piece][b];
 }
 
-inline bool hasCastle(BB castle, BB right) noexcept {
-    return (castle & right) == (right);
-}
 
 constexpr ndarray<BB, GAMESETUP_NB, COLOR_NB - 1, SIDE_NB> RIGHTS =
 {{{{
@@ -368,6 +375,24 @@ constexpr ndarray<BB, GAMESETUP_NB, COLOR_NB - 1, SIDE_NB> RIGHTS =
     { BB({O9 , O12}), BB({O9 , O5 }) },
 }}}};
 
+// Castling rights kept when a piece moves from or to a square: touching a
+// king or rook home square clears the rights that depend on it
+constexpr auto CASTLE_MASK = []() consteval
+{
+    ndarray<uint8_t, GAMESETUP_NB, SQUARE_NB> arr {};
+    for (auto setup : {Classic, Modern})
+        for (std::size_t sq = 0; sq < SQUARE_NB; ++sq)
+        {
+            uint8_t mask = 0xFF;
+            for (auto color : COLORS)
+                for (auto side : SIDES)
+                    if (RIGHTS[setup][color][side].checkSQ(Square(sq)))
+                        mask &= ~castleBit(color, side);
+            arr[setup][sq] = mask;
+        }
+    return arr;
+}();
+
 constexpr ndarray<BB, GAMESETUP_NB, COLOR_NB - 1, SIDE_NB> PASS =
 {{{{
     { BB({J2 , K2 }), BB({F2 , G2 , H2 }) },
@@ -1,7 +1,9 @@
 #ifndef CHESS_H
 #define CHESS_H
 
+#include <cassert>
 #include <cstdint>
+#include <cstddef>
 #include <array>
 #include <vector>
 
@@ -201,6 +203,8 @@ class Move
         inline auto nature() const noexcept {
             return static_cast<MoveNature>((encoded >> 16) & 0x7);
         }
+
+        constexpr bool operator==(const Move&) const noexcept = default;
 };
 
 /******************** constant ********************/
@@ -224,6 +228,10 @@ constexpr std::size_t GAMESETUP_NB = 2;
 
 constexpr int CHUNK_NB = 4;
 constexpr int MAX_MOVES = 256;
+constexpr int MAX_PLY = 1024; // Game history plus search depth a Position can hold
+
+// Material values indexed by Piece, kings and non-pieces count nothing
+constexpr std::array<int, PIECE_NB> PIECE_VALUE = { 0, 300, 300, 500, 900, 100, 0, 0 };
 
 /******************** method ********************/
 
@@ -247,10 +255,30 @@ constexpr bool isValidSquare(int r, int f) noexcept
     return (b1 && b2) && !(b3 || b4 || b5 || b6);
 }
 
+// One castling right per color and side, e.g. Blue QueenSide -> bit 3
+constexpr inline uint8_t castleBit(Color color, Side side) noexcept {
+    return static_cast<uint8_t>(1 << (color * SIDE_NB + side));
+}
+
 inline auto next(Color color) noexcept {
     return static_cast<Color>((color + 1) & 0b11);
 }
 
+// One bit per player still in the game, e.g. Yellow -> bit 2
+constexpr uint8_t ALL_ALIVE = 0b1111;
+
+constexpr inline uint8_t aliveBit(Color color) noexcept {
+    return static_cast<uint8_t>(1 << color);
+}
+
+// Next player still in the game, skipping eliminated ones
+inline auto next(Color color, uint8_t alive) noexcept
+{
+    assert(alive & ALL_ALIVE);
+    do color = next(color); while (!(alive & aliveBit(color)));
+    return color;
+}
+
 constexpr auto ALL_SQUARES = []
 {
     std::array<Square, SQUARE_NB> arr{};
@@ -272,6 +300,16 @@ constexpr auto VALID_SQUARES = []
     return arr;
 }();
 
+// Position of each square in VALID_SQUARES, every stone maps to BOARDSIZE
+constexpr auto SQUARE_INDEX = []
+{
+    std::array<uint8_t, SQUARE_NB> arr{};
+    arr.fill(BOARDSIZE);
+    for (std::size_t i = 0; i < BOARDSIZE; ++i)
+        arr[VALID_SQUARES[i]] = static_cast<uint8_t>(i);
+    return arr;
+}();
+
 constexpr std::array<Side, SIDE_NB> SIDES = {KingSide, QueenSide};
 
 constexpr std::array<Color, COLOR_NB - 1> COLORS = {Red, Blue, Yellow, Green};
@@ -0,0 +1,11 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+// Build-time switches, set from CMake options
+
+// Search statistics (stats.h), -DATHENA_STATS=ON in CMake
+#ifndef ATHENA_STATS
+#define ATHENA_STATS 0
+#endif
+
+#endif // #ifndef CONFIG_H
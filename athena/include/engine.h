@@ -4,8 +4,17 @@
 #include <CLI/CLI.hpp>
 #include <iostream>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "chess.h"
 #include "position.h"
+#include "search.h"
+#include "nnue/nnue.h"
+#include "trace.h"
 
 namespace athena
 {
@@ -18,46 +27,116 @@ class Engine
     private:
 
         Position pos;
+        NNUE nnue;
         CLI::App app{"Athena Engine CLI"};
 
         // Configuration
         bool debug = false;
+        int multipv = 1; // root lines each search reports
 
-        // Position options
-        std::string position_mode;
+        // Search trace, written on every go while trace_file is set
+        Tracer tracer;
+        std::string trace_file;
+        int trace_sample = 1;
+        int trace_depth = MAX_PLY;
+        int  status = 0; // process exit status, set when a check fails
+
+        // Search running in the background on a copy of the position.
+        // held, pondering, analysing and deferred are shared with it under search_mutex.
+        static constexpr int DEFAULT_DEPTH = 3;
+        static constexpr int MOVES_TO_GO = 30; // a clock without movestogo is split over
+        std::thread searcher;
+        SearchControl control;
+        std::unique_ptr<Position> search_pos = std::make_unique<Position>();
+        std::mutex search_mutex;
+        bool pondering = false;  // go ponder until ponderhit or stop
+        bool analysing = false;  // go infinite until stop
+        bool deferred = false;   // go ponder off the expected line, starts at ponderhit
+        std::string held;        // bestmove line waiting for ponderhit or stop
+        int go_depth = DEFAULT_DEPTH;
+        int go_movetime = 0;
+
+        // Best line of the last search, each move with the hash it is played from
+        std::vector<std::pair<uint64_t, Move>> expected;
+        Color expected_turn = None;
+
+        // Last position command, "<setup>" and "<move> <move> ...", so a
+        // resent game only plays the moves that are new
+        std::string position_setup;
+        std::string position_moves;
 
         // Perft options
         int  perft_depth;
         bool perft_full;
         bool perft_split;
         bool perft_cumulative;
+        int  perft_threads;
+        int  perft_hash;
+        bool perft_copy;
+        std::string perft_against;
+
+        // Perft suite options
+        std::string suite_input;
+        std::string suite_output;
+        int  suite_threads;
+        bool suite_csv;
+
+        // Bench options
+        int  bench_depth;
+        int  bench_threads;
+
+        // Score options
+        std::string score_input;
+        std::string score_output;
 
         // Print options
         bool print_config = false;
         bool print_fen = false;
         bool print_ascii_pieces = false;
 
-        // UCI commands
-        void handleUCI();
-        void handleIsReady();
-        void handleSetOption();
-        void handleUCINewGame();
-        void handlePosition();
-        void handleGo();
-        void handleStop();
-        void handleQuit();
-
-        // Other commands
+        // UCI commands, each gets the rest of its line
+        void handleUCI(std::string_view args);
+        void handleIsReady(std::string_view args);
+        void handleSetOption(std::string_view args);
+        void handleUCINewGame(std::string_view args);
+        void handlePosition(std::string_view args);
+        void handleGo(std::string_view args);
+        void handlePonderHit(std::string_view args);
+        void handleStop(std::string_view args);
+        void handleQuit(std::string_view args);
+
+        // Other commands, parsed by CLI11
         void handlePerft();
+        void handlePerftSuite();
+        void handleBench();
+        void handleScore();
         void handlePrint();
         // void handleConfig();
+
+        // Starts the search thread on search_pos with the limits in control
+        void startSearch();
+
+        // Body of the search thread started by go
+        void runSearch();
+
+        // Waits for the running search, stopping it if it would never end
+        void finish();
         
     public:
 
         Engine();
 
+        // Reads commands from stdin until EOF or quit
         void launch();
+
+        // Runs one UCI command line without allocating, false if the first
+        // word is not a UCI command
+        bool dispatch(std::string_view line);
+
+        // Runs a non-UCI command line through CLI11
         void execute(int argc, const char* argv[]);
+
+        int exitStatus() const { return status; }
 };
 
 } // namespace athena
@@ -4,9 +4,25 @@
 
 
 #include "position.h"
+#include "thread.h"
 
 namespace athena {
-int evaluate(const Position& pos);
+
+// Margin beyond the search window at which the NNUE is skipped (UCI NNUEThreshold)
+extern int NNUE_THRESHOLD;
+
+// Material plus mobility. Mobility briefly hands the move to each player,
+// so pos is modified but left as it was found.
+int evaluate(Position& pos);
+
+// Material balance of the side to move's team against the other, from
+// Board's counters. Eliminated players' pieces count for nobody.
+int material(const Position& pos);
+
+// Hybrid evaluation: the NNUE if one is loaded, unless material alone is
+// already NNUE_THRESHOLD outside [alpha, beta], where the classical
+// evaluate(pos) is returned instead
+int evaluate(Position& pos, Thread& thread, int alpha, int beta);
 }
 
-#endif // #ifndef EVAL_H
\ No newline at end of file
+#endif // #ifndef EVAL_H
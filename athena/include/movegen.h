@@ -7,14 +7,18 @@
 namespace athena
 {
 
-bool isSquareAttacked(const Position& pos, Square source, Color color) noexcept;
-bool isRoyalSafe(const Position& pos, Color color) noexcept;
 //
 bool isSquareAttacked(const Position& pos, Square source, Color color) noexcept;
 
 //
 bool isRoyalSafe(const Position& pos, Color color) noexcept;
 
+// Pieces of `color` that are the only blocker between its king and an enemy slider
+BitBoard pinnedPieces(const Position& pos, Color color) noexcept;
+
+// Whether a pseudo-legal move leaves the mover's king safe, without making it
+bool isLegal(const Position& pos, Move move) noexcept;
+
 // Move generation
 int genAllNoisyMoves(const Position& pos, Move* moves);
 int genAllQuietMoves(const Position& pos, Move* moves);
@@ -2,6 +2,7 @@
 #define NNUE_RELU_H
 
 #include <algorithm>
+#include <istream>
 
 namespace athena
 {
@@ -10,9 +11,23 @@ namespace athena
     class ReLU
     {
     public:
-        void propagatge(const int *input, int *output) const
+        static constexpr std::size_t InputSize = Size;
+        static constexpr std::size_t OutputSize = Size;
+        static constexpr std::size_t Parameters = 0;
+
+        bool read(std::istream &) { return true; }
+
+        void propagate(const int *input, int *output) const
+        {
+            for (std::size_t i = 0; i < Size; ++i)
+            {
+                output[i] = std::max(0, input[i]);
+            }
+        }
+
+        void propagate(const int *input, int *output, std::size_t batch) const
         {
-            for (int i = 0; i < Size; ++i)
+            for (std::size_t i = 0; i < Size * batch; ++i)
             {
                 output[i] = std::max(0, input[i]);
             }
@@ -0,0 +1,41 @@
+#ifndef NNUE_CLIPPED_RELU_H
+#define NNUE_CLIPPED_RELU_H
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+
+namespace athena
+{
+
+    // ReLU bounded above, keeps deeper layers in a fixed integer range
+    template <std::size_t Size, int32_t Max = 127>
+    class ClippedReLU
+    {
+    public:
+        static constexpr std::size_t InputSize = Size;
+        static constexpr std::size_t OutputSize = Size;
+        static constexpr std::size_t Parameters = 0;
+
+        bool read(std::istream &) { return true; }
+
+        void propagate(const int32_t *input, int32_t *output) const
+        {
+            for (std::size_t i = 0; i < Size; ++i)
+            {
+                output[i] = std::clamp(input[i], 0, Max);
+            }
+        }
+
+        void propagate(const int32_t *input, int32_t *output, std::size_t batch) const
+        {
+            for (std::size_t i = 0; i < Size * batch; ++i)
+            {
+                output[i] = std::clamp(input[i], 0, Max);
+            }
+        }
+    };
+
+} // namespace athena
+
+#endif /* NNUE_CLIPPED_RELU_H */
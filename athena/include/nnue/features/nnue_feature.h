@@ -7,13 +7,22 @@
 namespace athena
 {
 
-    int feature_index(Square sq, PieceClass pc)
+    // Maps a 256-square index onto the 160 playable squares
+    constexpr auto FEATURE_SQUARE = []
+    {
+        ndarray<int, SQUARE_NB> arr{};
+        for (std::size_t i = 0; i < BOARDSIZE; ++i)
+            arr[VALID_SQUARES[i]] = static_cast<int>(i);
+        return arr;
+    }();
+
+    inline int feature_index(Square sq, PieceClass pc)
     {
         auto piece = pc.piece();
         auto color = pc.color();
-        return color + (piece * 4) + (sq * 24);
+        return color + (piece * 4) + (FEATURE_SQUARE[sq] * 24);
     }
 
 } // namespace athena
 
-#endif /* NNUE_FEATURE_H */
\ No newline at end of file
+#endif /* NNUE_FEATURE_H */
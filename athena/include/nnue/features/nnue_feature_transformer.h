@@ -25,6 +25,15 @@ namespace athena
                 }
             }
         }
+
+        // Writes the active feature indices in ascending order, returns the count
+        int active(const Position &pos, int *indices) const
+        {
+            int size = 0;
+            for (auto sq : pos.board.everyone())
+                indices[size++] = feature_index(sq, pos.board[sq]);
+            return size;
+        }
     };
 
 } // namespace athena
@@ -2,6 +2,8 @@
 #define NNUE_DENSE_H
 
 #include <cstdint>
+#include <istream>
+#include <algorithm>
 #include "../nnue_config.h"
 
 namespace athena
@@ -15,24 +17,105 @@ namespace athena
         alignas(CacheLineSize) int32_t biases_[outSize];
 
     public:
+        static constexpr std::size_t InputSize = inSize;
+        static constexpr std::size_t OutputSize = outSize;
+        static constexpr std::size_t Parameters = inSize * outSize + outSize;
+
         int32_t (&weights())[outSize][inSize] { return weights_; }
         int32_t (&biases())[outSize] { return biases_; }
 
         const int32_t (&weights() const)[outSize][inSize] { return weights_; }
         const int32_t (&biases() const)[outSize] { return biases_; }
 
-        void propagate(const int32_t *input, int32_t *output)
+        // Raw int32 weights followed by the biases, in memory order
+        bool read(std::istream &stream)
+        {
+            stream.read(reinterpret_cast<char *>(weights_), sizeof(weights_));
+            stream.read(reinterpret_cast<char *>(biases_), sizeof(biases_));
+            return static_cast<bool>(stream);
+        }
+
+        // Inputs that come out of an activation are mostly zero, so the blocks
+        // holding any non-zero value are found once and only those are used
+        void propagate(const int32_t *input, int32_t *output) const
+        {
+            constexpr std::size_t BlockCount = (inSize + SparseBlockSize - 1) / SparseBlockSize;
+
+            std::size_t blocks[BlockCount];
+            std::size_t count = 0;
+
+            for (std::size_t b = 0; b < BlockCount; ++b)
+            {
+                std::size_t end = std::min((b + 1) * SparseBlockSize, inSize);
+
+                int32_t any = 0;
+                for (std::size_t j = b * SparseBlockSize; j < end; ++j)
+                    any |= input[j];
+
+                if (any != 0)
+                    blocks[count++] = b;
+            }
+
+            for (std::size_t i = 0; i < outSize; ++i)
+            {
+                int32_t sum = biases_[i];
+
+                for (std::size_t k = 0; k < count; ++k)
+                {
+                    std::size_t begin = blocks[k] * SparseBlockSize;
+                    std::size_t end = std::min(begin + SparseBlockSize, inSize);
+                    for (std::size_t j = begin; j < end; ++j)
+                        sum += weights_[i][j] * input[j];
+                }
+
+                output[i] = sum;
+            }
+        }
+
+        // Batched propagation over `batch` rows of input and output, laid out
+        // row after row. Each weight row is reused across a block of inputs
+        // while it is hot, with independent sums the compiler can vectorize.
+        void propagate(const int32_t *input, int32_t *output, std::size_t batch) const
         {
-            for (int j = 0; j < outSize; ++j)
+            constexpr std::size_t Block = 4;
+
+            std::size_t b = 0;
+            for (; b + Block <= batch; b += Block)
             {
-                output[j] = biases_[j];
+                const int32_t *x0 = input + (b + 0) * inSize;
+                const int32_t *x1 = input + (b + 1) * inSize;
+                const int32_t *x2 = input + (b + 2) * inSize;
+                const int32_t *x3 = input + (b + 3) * inSize;
+
+                for (std::size_t i = 0; i < outSize; ++i)
+                {
+                    const int32_t *w = weights_[i];
+                    int32_t s0 = biases_[i], s1 = biases_[i], s2 = biases_[i], s3 = biases_[i];
+
+                    for (std::size_t j = 0; j < inSize; ++j)
+                    {
+                        s0 += w[j] * x0[j];
+                        s1 += w[j] * x1[j];
+                        s2 += w[j] * x2[j];
+                        s3 += w[j] * x3[j];
+                    }
+
+                    output[(b + 0) * outSize + i] = s0;
+                    output[(b + 1) * outSize + i] = s1;
+                    output[(b + 2) * outSize + i] = s2;
+                    output[(b + 3) * outSize + i] = s3;
+                }
             }
 
-            for (int j = 0; j < inSize; ++j)
+            for (; b < batch; ++b)
             {
-                for (int i = 0; i < outSize; ++i)
+                const int32_t *x = input + b * inSize;
+                for (std::size_t i = 0; i < outSize; ++i)
                 {
-                    output[i] += weights_[i][j] * input[j];
+                    int32_t sum = biases_[i];
+                    for (std::size_t j = 0; j < inSize; ++j)
+                        sum += weights_[i][j] * x[j];
+                    output[b * outSize + i] = sum;
                 }
             }
         }
@@ -0,0 +1,74 @@
+#ifndef NNUE_SPARSE_DENSE_H
+#define NNUE_SPARSE_DENSE_H
+
+#include <cstdint>
+#include <istream>
+#include "../nnue_config.h"
+
+namespace athena
+{
+
+    // Dense layer for one-hot inputs given as a list of active indices.
+    // Weights are stored column-major, so each input owns one contiguous
+    // column of outSize values that can be added with plain vector loads.
+    template <std::size_t inSize, std::size_t outSize>
+    class SparseDense
+    {
+    private:
+        alignas(CacheLineSize) int32_t weights_[inSize][outSize];
+        alignas(CacheLineSize) int32_t biases_[outSize];
+
+    public:
+        static constexpr std::size_t InputSize = inSize;
+        static constexpr std::size_t OutputSize = outSize;
+        static constexpr std::size_t Parameters = inSize * outSize + outSize;
+
+        int32_t (&weights())[inSize][outSize] { return weights_; }
+        int32_t (&biases())[outSize] { return biases_; }
+
+        const int32_t (&weights() const)[inSize][outSize] { return weights_; }
+        const int32_t (&biases() const)[outSize] { return biases_; }
+
+        // Raw int32 weights followed by the biases, in memory order
+        bool read(std::istream &stream)
+        {
+            stream.read(reinterpret_cast<char *>(weights_), sizeof(weights_));
+            stream.read(reinterpret_cast<char *>(biases_), sizeof(biases_));
+            return static_cast<bool>(stream);
+        }
+
+        void add(int index, int32_t *output) const
+        {
+            const int32_t *column = weights_[index];
+            for (std::size_t i = 0; i < outSize; ++i)
+            {
+                output[i] += column[i];
+            }
+        }
+
+        void sub(int index, int32_t *output) const
+        {
+            const int32_t *column = weights_[index];
+            for (std::size_t i = 0; i < outSize; ++i)
+            {
+                output[i] -= column[i];
+            }
+        }
+
+        void propagate(const int *indices, int count, int32_t *output) const
+        {
+            for (std::size_t i = 0; i < outSize; ++i)
+            {
+                output[i] = biases_[i];
+            }
+
+            for (int k = 0; k < count; ++k)
+            {
+                add(indices[k], output);
+            }
+        }
+    };
+
+} // namespace athena
+
+#endif /* NNUE_SPARSE_DENSE_H */
@@ -1,17 +1,50 @@
 #ifndef NNUE_H
 #define NNUE_H
 
+#include <memory>
+#include <string>
 #include "position.h"
+#include "nnue_config.h"
+#include "nnue_model.h"
+#include "nnue_architecture.h"
 
 namespace athena
 {
 
     class NNUE
     {
+    private:
+        std::unique_ptr<ModelBase> model;
+        bool loaded_ = false;
+
     public:
-        int32_t evaluate(const Position &pos);
+        NNUE();
+
+        // Network file: magic, version, architecture id, then the raw int32
+        // weights and biases of each layer in order. The architecture is
+        // looked up in Architectures. Returns false and stays unloaded on error.
+        bool load(const std::string &path);
+        bool loaded() const { return loaded_; }
+
+        const char *architecture() const { return model->name(); }
+
+        // Keep the accumulator stack in step with Position::makemove/undomove.
+        // reset() must be called whenever the position is set up from scratch.
+        void reset() { model->reset(); }
+        void push() { model->push(); }
+        void pop() { model->pop(); }
+
+        // The network scores from Red/Yellow's point of view, evaluate()
+        // returns it relative to the side to move
+        int32_t evaluate(const Position &pos) { return model->evaluate(pos); }
+
+        // Scores unrelated positions in bulk, leaving the accumulator stack alone
+        void evaluate(const Position *positions, std::size_t size, int32_t *scores)
+        {
+            model->evaluate(positions, size, scores);
+        }
     };
 
 } // namespace athena
 
-#endif /* NNUE_H */
\ No newline at end of file
+#endif /* NNUE_H */
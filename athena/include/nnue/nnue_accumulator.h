@@ -1,8 +1,11 @@
 #ifndef NNUE_ACCUMULATOR_H
 #define NNUE_ACCUMULATOR_H
 
+#include <cassert>
 #include <cstdint>
+#include <vector>
 #include "chess.h"
+#include "nnue_config.h"
 
 namespace athena
 {
@@ -10,17 +13,48 @@ namespace athena
     template <std::size_t size>
     class Accumulator
     {
-    private:
-        alignas(CacheLineSize) int data[size];
+    public:
+        alignas(CacheLineSize) int32_t data[size];
+        bool computed = false;
     };
 
+    // One accumulator per ply, kept in step with Position::states through
+    // push/pop. Entries are only marked dirty on push and get computed on
+    // demand, so nodes that are never evaluated cost no accumulator work.
+    // Like the state stack it holds MAX_PLY entries, allocated up front.
     template <std::size_t size>
     class AccumulatorStack
     {
     private:
         std::vector<Accumulator<size>> stack;
+        std::size_t top = 0;
+
+    public:
+        AccumulatorStack() : stack(MAX_PLY) {}
+
+        Accumulator<size> &operator[](std::size_t ply) { return stack[ply]; }
+        const Accumulator<size> &operator[](std::size_t ply) const { return stack[ply]; }
+
+        std::size_t ply() const { return top; }
+
+        void reset()
+        {
+            top = 0;
+            stack[0].computed = false;
+        }
+
+        void push()
+        {
+            assert(top + 1 < stack.size());
+            stack[++top].computed = false;
+        }
+
+        void pop()
+        {
+            --top;
+        }
     };
 
 } // namespace athena
 
-#endif /* NNUE_ACCUMULATOR_H */
\ No newline at end of file
+#endif /* NNUE_ACCUMULATOR_H */
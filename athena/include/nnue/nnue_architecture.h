@@ -0,0 +1,55 @@
+#ifndef NNUE_ARCHITECTURE_H
+#define NNUE_ARCHITECTURE_H
+
+#include <cstdint>
+#include <tuple>
+#include "nnue_config.h"
+#include "nnue_network.h"
+#include "activations/nnue_ReLU.h"
+#include "activations/nnue_clipped_ReLU.h"
+#include "layers/nnue_dense.h"
+#include "layers/nnue_sparse_dense.h"
+
+namespace athena
+{
+
+    // Precompiled architectures. A network file names one by Id in its
+    // header; Input is the incrementally updated first layer and Output the
+    // stack that runs on top of its accumulator.
+
+    struct Arch128
+    {
+        static constexpr uint32_t Id = 1;
+        static constexpr const char *Name = "128x1";
+
+        using Input = SparseDense<Lx0, 128>;
+        using Output = Network<ReLU<128>, Dense<128, 1>>;
+    };
+
+    struct Arch512x16
+    {
+        static constexpr uint32_t Id = 2;
+        static constexpr const char *Name = "512x16x1";
+
+        using Input = SparseDense<Lx0, 512>;
+        using Output = Network<ClippedReLU<512>, Dense<512, 16>,
+                               ClippedReLU<16>, Dense<16, 1>>;
+    };
+
+    struct Arch256x32x32
+    {
+        static constexpr uint32_t Id = 3;
+        static constexpr const char *Name = "256x32x32x1";
+
+        using Input = SparseDense<Lx0, 256>;
+        using Output = Network<ClippedReLU<256>, Dense<256, 32>,
+                               ClippedReLU<32>, Dense<32, 32>,
+                               ClippedReLU<32>, Dense<32, 1>>;
+    };
+
+    using Architectures = std::tuple<Arch128, Arch512x16, Arch256x32x32>;
+    using DefaultArch = Arch128;
+
+} // namespace athena
+
+#endif /* NNUE_ARCHITECTURE_H */
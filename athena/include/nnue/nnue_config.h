@@ -8,10 +8,14 @@ namespace athena
 
     constexpr int CacheLineSize = 32;
 
-    constexpr std::size_t Lx0 = 6 * 4 * 160; // 3840 input features
-    constexpr std::size_t Lx1 = 128;         // Hidden layer size, example value
-    constexpr std::size_t Lx2 = 1;
+    constexpr std::size_t Lx0 = 6 * 4 * 160; // 3840 input features, layer sizes live in nnue_architecture.h
+
+    constexpr uint32_t NetworkMagic = 0x4E485441; // "ATHN" in little endian
+    constexpr uint32_t NetworkVersion = 2; // Header: magic, version, architecture id
+
+    constexpr std::size_t BatchSize = 64;             // Positions per batched forward pass
+    constexpr std::size_t SparseBlockSize = 8;        // Inputs per non-zero block (one AVX2 register)
 
 } // namespace athena
 
-#endif /* NNUE_CONFIG_H */
\ No newline at end of file
+#endif /* NNUE_CONFIG_H */
@@ -0,0 +1,148 @@
+#ifndef NNUE_MODEL_H
+#define NNUE_MODEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <vector>
+#include "position.h"
+#include "nnue_config.h"
+#include "nnue_accumulator.h"
+#include "features/nnue_feature_transformer.h"
+
+namespace athena
+{
+
+    // What NNUE needs from a network, independent of its architecture
+    class ModelBase
+    {
+    public:
+        virtual ~ModelBase() = default;
+
+        virtual const char *name() const = 0;
+        virtual bool read(std::istream &stream) = 0;
+
+        virtual void reset() = 0;
+        virtual void push() = 0;
+        virtual void pop() = 0;
+
+        virtual int32_t evaluate(const Position &pos) = 0;
+        virtual void evaluate(const Position *positions, std::size_t size, int32_t *scores) = 0;
+    };
+
+    // One architecture from nnue_architecture.h with every dimension known at
+    // compile time. The first layer is kept incrementally on an accumulator
+    // stack, the rest of the network runs on top of it at evaluation.
+    template <typename Arch>
+    class Model final : public ModelBase
+    {
+    public:
+        using Input = typename Arch::Input;
+        using Output = typename Arch::Output;
+
+        static constexpr std::size_t Hidden = Input::OutputSize;
+        static constexpr std::size_t Parameters = Input::Parameters + Output::Parameters;
+
+        static_assert(Input::InputSize == Lx0, "first layer must take every feature");
+        static_assert(Output::InputSize == Hidden, "network must take the accumulator");
+
+    private:
+        FeatureTransformer transformer;
+        std::unique_ptr<Input> input_ = std::make_unique<Input>();
+        std::unique_ptr<Output> output_ = std::make_unique<Output>();
+        AccumulatorStack<Hidden> accumulators;
+        std::vector<int32_t> hidden = std::vector<int32_t>(BatchSize * Hidden);
+
+        void refresh(const Position &pos, Accumulator<Hidden> &acc) const
+        {
+            int indices[BOARDSIZE];
+            int count = transformer.active(pos, indices);
+            input_->propagate(indices, count, acc.data);
+            acc.computed = true;
+        }
+
+        void update(const DirtyPiece &dirty, const Accumulator<Hidden> &prev, Accumulator<Hidden> &next) const
+        {
+            std::copy(prev.data, prev.data + Hidden, next.data);
+
+            for (int k = 0; k < dirty.size; ++k)
+            {
+                if (dirty.from[k] != OFFBOARD)
+                    input_->sub(feature_index(dirty.from[k], dirty.piece[k]), next.data);
+
+                if (dirty.to[k] != OFFBOARD)
+                    input_->add(feature_index(dirty.to[k], dirty.piece[k]), next.data);
+            }
+
+            next.computed = true;
+        }
+
+    public:
+        Input &input() { return *input_; }
+        Output &output() { return *output_; }
+
+        const char *name() const override { return Arch::Name; }
+
+        bool read(std::istream &stream) override
+        {
+            bool ok = input_->read(stream) && output_->read(stream);
+            accumulators.reset();
+            return ok;
+        }
+
+        void reset() override { accumulators.reset(); }
+        void push() override { accumulators.push(); }
+        void pop() override { accumulators.pop(); }
+
+        int32_t evaluate(const Position &pos) override
+        {
+            auto ply = accumulators.ply();
+
+            // Walk back to the nearest ancestor whose accumulator is up to date
+            auto base = ply;
+            while (base > 0 && !accumulators[base].computed)
+                --base;
+
+            if (!accumulators[base].computed)
+                refresh(pos, accumulators[ply]);
+
+            // Replay the recorded deltas forward, states.back() matches the top entry
+            else
+            {
+                auto offset = pos.states.size() - 1 - ply;
+                for (auto i = base + 1; i <= ply; ++i)
+                    update(pos.states[offset + i].dirty, accumulators[i - 1], accumulators[i]);
+            }
+
+            auto score = output_->propagate(accumulators[ply].data);
+            return toGuild(pos.states.back().turn) == RY ? score : -score;
+        }
+
+        void evaluate(const Position *positions, std::size_t size, int32_t *scores) override
+        {
+            int indices[BOARDSIZE];
+
+            for (std::size_t start = 0; start < size; start += BatchSize)
+            {
+                auto batch = std::min(BatchSize, size - start);
+
+                // First layer: only the columns of active features are summed
+                for (std::size_t b = 0; b < batch; ++b)
+                {
+                    int count = transformer.active(positions[start + b], indices);
+                    input_->propagate(indices, count, &hidden[b * Hidden]);
+                }
+
+                output_->propagate(hidden.data(), scores + start, batch);
+
+                for (std::size_t b = 0; b < batch; ++b)
+                    if (toGuild(positions[start + b].states.back().turn) != RY)
+                        scores[start + b] = -scores[start + b];
+            }
+        }
+    };
+
+} // namespace athena
+
+#endif /* NNUE_MODEL_H */
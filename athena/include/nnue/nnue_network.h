@@ -1,31 +1,119 @@
 #ifndef NNUE_NETWORK_H
 #define NNUE_NETWORK_H
 
+#include <algorithm>
 #include <cstdint>
+#include <istream>
+#include <tuple>
+#include <utility>
+#include "nnue_config.h"
 
 namespace athena
 {
 
-    template <std::size_t L1, std::size_t L2>
+    // A stack of layers fixed at compile time, e.g.
+    //   Network<ClippedReLU<512>, Dense<512, 16>, ClippedReLU<16>, Dense<16, 1>>
+    // Every layer exposes InputSize/OutputSize, read() and propagate(), so the
+    // stack is unrolled into straight-line calls with all dimensions constant.
+    template <typename... Layers>
     class Network
     {
+        static_assert(sizeof...(Layers) > 0, "a network needs at least one layer");
+
+    public:
+        static constexpr std::size_t Depth = sizeof...(Layers);
+
+        template <std::size_t I>
+        using Layer = std::tuple_element_t<I, std::tuple<Layers...>>;
+
+        static constexpr std::size_t InputSize = Layer<0>::InputSize;
+        static constexpr std::size_t OutputSize = Layer<Depth - 1>::OutputSize;
+        static constexpr std::size_t Parameters = (Layers::Parameters + ...);
+
     private:
-        ReLU<L1> relu1;
-        Dense<L1, L2> dense2;
+        template <std::size_t... I>
+        static constexpr bool chained(std::index_sequence<I...>)
+        {
+            return ((Layer<I>::OutputSize == Layer<I + 1>::InputSize) && ... && true);
+        }
+
+        static_assert(chained(std::make_index_sequence<Depth - 1>()), "layer sizes do not chain");
 
-        alignas(CacheLineSize) a1[L1];
-        alignas(CacheLineSize) z2[L2];
+        template <std::size_t Size>
+        struct alignas(CacheLineSize) Buffer
+        {
+            int32_t data[Size];
+        };
+
+        using Buffers = std::tuple<Buffer<Layers::OutputSize>...>;
+
+        // Room for BatchSize rows of every layer output, kept with the network
+        // rather than allocated on every batched call
+        template <std::size_t Size>
+        struct alignas(CacheLineSize) BatchBuffer
+        {
+            int32_t data[Size * BatchSize];
+        };
+
+        using BatchBuffers = std::tuple<BatchBuffer<Layers::OutputSize>...>;
+
+        std::tuple<Layers...> layers_;
+        BatchBuffers batch_;
+
+        template <std::size_t I>
+        void forward(const int32_t *input, Buffers &buffers) const
+        {
+            int32_t *output = std::get<I>(buffers).data;
+            std::get<I>(layers_).propagate(input, output);
+
+            if constexpr (I + 1 < Depth)
+                forward<I + 1>(output, buffers);
+        }
+
+        template <std::size_t I>
+        void forward(const int32_t *input, int32_t *output, std::size_t batch)
+        {
+            int32_t *z = std::get<I>(batch_).data;
+            std::get<I>(layers_).propagate(input, z, batch);
+
+            if constexpr (I + 1 < Depth)
+                forward<I + 1>(z, output, batch);
+            else
+                for (std::size_t b = 0; b < batch; ++b)
+                    output[b] = z[b * OutputSize];
+        }
 
     public:
-        int32_t propagate(const int32_t *input)
+        template <std::size_t I>
+        Layer<I> &layer() { return std::get<I>(layers_); }
+
+        template <std::size_t I>
+        const Layer<I> &layer() const { return std::get<I>(layers_); }
+
+        Layer<Depth - 1> &output() { return layer<Depth - 1>(); }
+
+        bool read(std::istream &stream)
+        {
+            return std::apply([&](auto &...layer) { return (layer.read(stream) && ...); }, layers_);
+        }
+
+        int32_t propagate(const int32_t *input) const
         {
-            relu1.propagate(input, a1);
-            dense2.propagate(a1, z2);
+            Buffers buffers;
+            forward<0>(input, buffers);
 
-            return z2[0];
+            return std::get<Depth - 1>(buffers).data[0];
+        }
+
+        // Scores `batch` input rows at once, writing the first output of each.
+        // Rows go through the scratch buffers BatchSize at a time.
+        void propagate(const int32_t *input, int32_t *output, std::size_t batch)
+        {
+            for (std::size_t start = 0; start < batch; start += BatchSize)
+                forward<0>(input + start * InputSize, output + start, std::min(BatchSize, batch - start));
         }
     };
 
 } // namespace athena
 
-#endif /* NNUE_NETWORK_H */
\ No newline at end of file
+#endif /* NNUE_NETWORK_H */
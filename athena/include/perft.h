@@ -1,5 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <istream>
+#include <ostream>
+#include <utility>
+#include <vector>
 #include "position.h"
 
 namespace athena
@@ -38,6 +44,65 @@ class Record
     }
 };
   
-void runPerftTests(Position& pos, int depth, bool full, bool split, bool cumulative);
+// Subtree counts keyed by (Zobrist key, depth), shared by all perft threads.
+// Node counts live in lock-free entries that store key ^ data beside data,
+// so a torn write fails the check. Full mode caches the whole Record and
+// guards each entry with a flag, skipping entries that are busy.
+class PerftTable
+{
+    private:
+
+        struct NodeEntry
+        {
+            std::atomic<uint64_t> check{0};
+            std::atomic<uint64_t> data{0}; // nodes << 8 | depth
+        };
+
+        struct RecordEntry
+        {
+            std::atomic_flag lock;
+            uint64_t key = 0;
+            int depth = 0;
+            Record rc;
+        };
+
+        bool full;
+        std::size_t mask;
+        std::unique_ptr<NodeEntry[]> nodes;
+        std::unique_ptr<RecordEntry[]> records;
+
+        std::size_t index(uint64_t key, int depth) const;
+
+    public:
+
+        PerftTable(std::size_t megabytes, bool full);
+
+        bool probe(uint64_t key, int depth, Record& rc);
+        void store(uint64_t key, int depth, const Record& rc);
+};
+
+// Policy picks how moves are taken back (MakeUnmake or CopyMake, see
+// position.h), both are instantiated in perft.cpp.
+
+// Counts the tree below pos on `threads` threads, each on its own copy of pos
+template <typename Policy = MakeUnmake>
+Record perft(Position& pos, int depth, bool full, int threads = 1, PerftTable* table = nullptr);
+
+// Per legal root move counts, work is split at ply 2 once depth >= 3
+template <typename Policy = MakeUnmake>
+std::vector<std::pair<Move, Record>> divide(Position& pos, int depth, bool full, int threads = 1, PerftTable* table = nullptr);
+
+template <typename Policy = MakeUnmake>
+void runPerftTests(Position& pos, int depth, bool full, bool split, bool cumulative, int threads = 1, std::size_t hash = 0);
+
+// Runs every "<fen> ;D1 <nodes> ;D2 <nodes> ..." line of `input`, positions
+// spread over `threads`, and writes JSON (or CSV) to `output`. Returns the
+// number of mismatching counts, throws std::invalid_argument on bad lines.
+int runPerftSuite(std::istream& input, std::ostream& output, int threads = 1, bool csv = false);
+
+// Compares our divide with a reference trace of "<move> [<move> ...]: <nodes>"
+// lines and descends into the first mismatching move for as long as the trace
+// goes, then prints the failing FEN, move path and move. Returns 1 on mismatch.
+int divideAgainst(Position& pos, int depth, std::istream& input, std::ostream& output, int threads = 1, PerftTable* table = nullptr);
 
 } // namespace athena
\ No newline at end of file
@@ -1,28 +1,68 @@
 #ifndef POSITION_H
 #define POSITION_H
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include "bitboard.h"
 #include "chess.h"
 
 namespace athena
 {
 
-class Board
+// Pieces changed by a single move, recorded for incremental NNUE updates.
+// A piece with from == OFFBOARD was added, one with to == OFFBOARD was removed.
+class DirtyPiece
+{
+    public:
+
+        uint8_t size = 0;
+        ndarray<PieceClass, 3> piece;
+        ndarray<Square, 3> from;
+        ndarray<Square, 3> to;
+
+        inline void add(PieceClass pc, Square source, Square target) noexcept
+        {
+            piece[size] = pc;
+            from[size] = source;
+            to[size] = target;
+            ++size;
+        }
+};
+
+// Only real pieces get bitboards, stones are the constant BRICK and empty
+// squares are whatever nobody occupies. The mailbox holds the 160 playable
+// squares in VALID_SQUARES order plus one slot every stone maps to, so the
+// whole board is 8 cache lines instead of 11.
+class alignas(64) Board
 {
     private:
 
-        ndarray<PieceClass, SQUARE_NB> mailbox;
-        ndarray<BitBoard, PIECE_NB> pieces;
-        ndarray<BitBoard, COLOR_NB> colors;
+        ndarray<BitBoard, PIECE_NB - 2> pieces;
+        ndarray<BitBoard, COLOR_NB - 1> colors;
+        ndarray<int, COLOR_NB - 1> material;
+        ndarray<PieceClass, BOARDSIZE + 1> mailbox;
 
     public:
 
+        // Everything but the mailbox, which a DirtyPiece is enough to restore
+        struct Snapshot
+        {
+            ndarray<BitBoard, PIECE_NB - 2> pieces;
+            ndarray<BitBoard, COLOR_NB - 1> colors;
+            ndarray<int, COLOR_NB - 1> material;
+        };
+
         Board() noexcept { clear(); }
 
         ~Board() noexcept = default;
 
         inline auto operator[](Square sq) const noexcept {
-            return mailbox[sq];
+            return mailbox[SQUARE_INDEX[sq]];
         }
 
         inline auto occ(Color color) const noexcept {
@@ -44,53 +84,98 @@ class Board
         inline auto opponent(Color color) const noexcept {
             return colors[OPPONENTS[color][0]] | colors[OPPONENTS[color][1]] ;
         }
+
+        // Opponents still in the game, eliminated pieces only block
+        inline auto opponent(Color color, uint8_t alive) const noexcept
+        {
+            BitBoard bb;
+            for (auto opp: OPPONENTS[color])
+                if (alive & aliveBit(opp)) bb |= colors[opp];
+            return bb;
+        }
     
         inline auto teammate(Color color) const noexcept {
             return colors[TEAMMATES[color][0]] | colors[TEAMMATES[color][1]] ;
         }
 
+        inline auto value(Color color) const noexcept {
+            return material[color];
+        }
+
         inline auto everyone() const noexcept {
             return colors[Red] | colors[Blue] | colors[Yellow] | colors[Green];
         }
 
         void clear() noexcept 
         {
-            for (auto sq : ALL_SQUARES)
-                mailbox[sq] = isValidSquare(rankSQ(sq), fileSQ(sq)) ? EMPTY : STONE;
+            mailbox.fill(EMPTY);
+            mailbox[BOARDSIZE] = STONE;
             pieces.fill(BB{});
             colors.fill(BB{});
+            material.fill(0);
         }
 
+        // Both take real pieces on playable squares only
         inline void setSQ(Square sq, PieceClass pc) noexcept
         {
-            mailbox[sq] = pc;
+            assert(pc.piece() < Empty && SQUARE_INDEX[sq] < BOARDSIZE);
+            mailbox[SQUARE_INDEX[sq]] = pc;
             pieces[pc.piece()].setSQ(sq);
             colors[pc.color()].setSQ(sq);
+            material[pc.color()] += PIECE_VALUE[pc.piece()];
         }
 
         inline void popSQ(Square sq) noexcept
         {
-            auto pc = mailbox[sq];
-            mailbox[sq] = EMPTY;
+            auto pc = mailbox[SQUARE_INDEX[sq]];
+            assert(pc.piece() < Empty);
+            mailbox[SQUARE_INDEX[sq]] = EMPTY;
             pieces[pc.piece()].popSQ(sq);
             colors[pc.color()].popSQ(sq);
+            material[pc.color()] -= PIECE_VALUE[pc.piece()];
         }
 
         inline auto royal(Color color) const noexcept {
             return (pieces[King] & colors[color]).lsb();
         }
+
+        inline void save(Snapshot& snap) const noexcept
+        {
+            snap.pieces = pieces;
+            snap.colors = colors;
+            snap.material = material;
+        }
+
+        // Takes back the move that produced `dirty`: targets are emptied first
+        // so a square both vacated and refilled ends up with its old piece
+        inline void restore(const Snapshot& snap, const DirtyPiece& dirty) noexcept
+        {
+            pieces = snap.pieces;
+            colors = snap.colors;
+            material = snap.material;
+
+            for (int k = 0; k < dirty.size; ++k)
+                if (dirty.to[k] != OFFBOARD) mailbox[SQUARE_INDEX[dirty.to[k]]] = EMPTY;
+
+            for (int k = 0; k < dirty.size; ++k)
+                if (dirty.from[k] != OFFBOARD) mailbox[SQUARE_INDEX[dirty.from[k]]] = dirty.piece[k];
+        }
 };
 
+static_assert(sizeof(Board) == 8 * 64, "Board should fill exactly 8 cache lines");
+
 class GameState
 {
     public:
 
         int clock;
         Color turn;
-        BitBoard hash;
-        BitBoard castle;
+        uint64_t hash;
+        uint8_t castle; // castleBit() per right still held
+        uint8_t alive;  // aliveBit() per player not eliminated
         PieceClass captured;
         ndarray<Square, COLOR_NB - 1> enpass;
+        DirtyPiece dirty;
 
         GameState()  noexcept = default;
         ~GameState() noexcept = default;
@@ -99,18 +184,85 @@ class GameState
         (
             int clock_,
             Color turn_,
-            BitBoard hash_,
-            BitBoard castle_,
+            uint64_t hash_,
+            uint8_t castle_,
+            uint8_t alive_,
             PieceClass captured_,
-            const ndarray<Square, COLOR_NB - 1>& enpass_
+            const ndarray<Square, COLOR_NB - 1>& enpass_,
+            const DirtyPiece& dirty_ = DirtyPiece()
         ) 
         noexcept : 
           clock(clock_),
           turn(turn_),
           hash(hash_),
           castle(castle_),
+          alive(alive_),
           captured(captured_),
-          enpass(enpass_) {}
+          enpass(enpass_),
+          dirty(dirty_) {}
+};
+
+// Fixed-capacity history of GameStates. Storage lives inline and is left
+// uninitialized, so push/pop never allocate and a copy only touches the
+// used plies. Capacity is only asserted on push: the search stops deepening
+// once full(), perft rejects depths beyond the room left and the engine
+// caps the moves a position command may replay.
+class StateStack
+{
+    private:
+
+        static_assert(std::is_trivially_copyable_v<GameState> && std::is_trivially_destructible_v<GameState>,
+                      "GameStates are copied as bytes and never destroyed");
+
+        alignas(64) std::byte storage[MAX_PLY * sizeof(GameState)];
+        std::size_t top = 0;
+
+        inline GameState* data() noexcept {
+            return std::launder(reinterpret_cast<GameState*>(storage));
+        }
+
+        inline const GameState* data() const noexcept {
+            return std::launder(reinterpret_cast<const GameState*>(storage));
+        }
+
+    public:
+
+        StateStack() noexcept {}
+
+        StateStack(const StateStack& other) noexcept : top(other.top) {
+            std::memcpy(storage, other.storage, top * sizeof(GameState));
+        }
+
+        StateStack& operator=(const StateStack& other) noexcept
+        {
+            top = other.top;
+            std::memmove(storage, other.storage, top * sizeof(GameState));
+            return *this;
+        }
+
+        inline auto size()  const noexcept { return top; }
+        inline bool empty() const noexcept { return top == 0; }
+        inline bool full()  const noexcept { return top == MAX_PLY; }
+
+        inline GameState& operator[](std::size_t i) noexcept { return data()[i]; }
+        inline const GameState& operator[](std::size_t i) const noexcept { return data()[i]; }
+
+        inline GameState& back() noexcept { return data()[top - 1]; }
+        inline const GameState& back() const noexcept { return data()[top - 1]; }
+
+        inline auto begin() const noexcept { return data(); }
+        inline auto end()   const noexcept { return data() + top; }
+
+        inline void clear() noexcept { top = 0; }
+
+        template <typename... Args>
+        inline GameState& emplace_back(Args&&... args) noexcept
+        {
+            assert(top < MAX_PLY);
+            return *std::construct_at(data() + top++, std::forward<Args>(args)...);
+        }
+
+        inline void pop_back() noexcept { --top; }
 };
 
 class Position
@@ -119,13 +271,66 @@ class Position
 
         Board board;
         GameSetup setup;
-        std::vector<GameState> states;
+        StateStack states;
 
         Position()  noexcept = default;
         ~Position() noexcept = default;
 
         void makemove(Move move);
         void undomove(Move move);
+
+        // Knocks the player to move out of the game and passes the turn on.
+        // Its pieces stay on the board as blockers, states.pop_back() undoes it.
+        void eliminate() noexcept;
+
+        // Whether this position occurred before with the same player to
+        // move since the last capture or pawn move. Less than `play` plies
+        // back (inside the search) once is enough, further back it takes two.
+        bool isRepetition(int play) const noexcept;
+
+        // Whether the player to move has a reversible move back to a
+        // position less than `play` plies back, so it can force a repetition
+        bool hasUpcomingRepetition(int play) const noexcept;
+};
+
+// Undo policies for perft walks. Both expose make(pos, move) /
+// undo(pos, move) and are picked as a template argument.
+
+// Undo reverses each move kind by hand through Position::undomove
+class MakeUnmake
+{
+    public:
+
+        inline void make(Position& pos, Move move) { pos.makemove(move); }
+        inline void undo(Position& pos, Move move) { pos.undomove(move); }
+};
+
+// Every make saves the bitboards first, undo copies them back and replays
+// the dirty list onto the mailbox, so no move kind needs special handling.
+// make still runs the full makemove, so this is no faster than MakeUnmake:
+// it is there to cross-check undomove (perft --copy-make), not for search.
+// One instance per thread, the snapshot stack is too large for the stack.
+class CopyMake
+{
+    private:
+
+        std::unique_ptr<Board::Snapshot[]> snapshots = std::make_unique<Board::Snapshot[]>(MAX_PLY);
+        std::size_t top = 0;
+
+    public:
+
+        inline void make(Position& pos, Move move)
+        {
+            assert(top < MAX_PLY);
+            pos.board.save(snapshots[top++]);
+            pos.makemove(move);
+        }
+
+        inline void undo(Position& pos, Move)
+        {
+            pos.board.restore(snapshots[--top], pos.states.back().dirty);
+            pos.states.pop_back();
+        }
 };
 
 } // namespace athena
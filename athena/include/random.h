@@ -0,0 +1,31 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+namespace athena
+{
+
+// xorshift64* generator, usable at compile time to build key tables
+class PRNG
+{
+    private:
+
+        uint64_t state;
+
+    public:
+
+        constexpr explicit PRNG(uint64_t seed) noexcept : state(seed) {}
+
+        constexpr uint64_t next() noexcept
+        {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 2685821657736338717ULL;
+        }
+};
+
+} // namespace athena
+
+#endif // #ifndef RANDOM_H
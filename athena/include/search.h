@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
 #include "position.h"  // Position
 #include "thread.h"    // Thread
 #include "chess.h"     // Move
@@ -17,8 +20,28 @@ extern Move MOVE_DRAW_FIFTY_MOVE;
 extern Move MOVE_CHECKMATE;
 extern Move MOVE_STALEMATE;
 
+// Limits of a running search, shared with the thread that controls it.
+// The search polls them, so they may change while it runs (ponderhit).
+struct SearchControl
+{
+    std::atomic<bool> stop{false};
+    std::atomic<int> depth{0};              // deepest iteration to start
+    std::atomic<std::int64_t> deadline{0};  // steady_clock nanoseconds, 0 for none
+    std::atomic<int> completed{0};          // deepest finished iteration
+    int multipv = 1;                        // root lines to report, set before the search
+
+    bool expired() const noexcept;
+};
+
 // Core search entry
 int negamax(Position& pos, Thread& thread, int alpha, int beta, int depth, int play = 0);
 
+// Iterative deepening up to control.depth, control.multipv info lines per
+// finished iteration on `output`: each line is the best root move left
+// once the earlier lines' moves are excluded. An interrupted iteration is
+// thrown away, so thread ends with the move, score and pv of the deepest
+// finished one.
+int search(Position& pos, Thread& thread, SearchControl& control, std::ostream& output);
+
 } // namespace athena
 
@@ -0,0 +1,86 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstdint>
+#include <ostream>
+#include "chess.h"
+#include "config.h"
+
+#if ATHENA_STATS
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace athena
+{
+
+enum StatTimer : uint8_t { MovegenTimer, EvalTimer, MakeUndoTimer, TIMER_NB };
+
+// Counters one search thread keeps about itself. Only built with ATHENA_STATS,
+// otherwise the STATS macros below expand to nothing and the search pays
+// neither the increments nor the timer reads.
+class SearchStats
+{
+    public:
+
+        // Cutoffs by the index of the legal move that caused them, the last
+        // bucket takes every later move
+        static constexpr int CUTOFF_BUCKETS = 8;
+
+        uint64_t nodes = 0;   // negamax nodes
+        uint64_t qnodes = 0;  // quiescence nodes
+        uint64_t illegal = 0; // pseudo-legal moves rejected by isLegal
+        uint64_t evals = 0;   // static evaluations
+        uint64_t cutoffs = 0; // beta cutoffs in negamax
+        ndarray<uint64_t, CUTOFF_BUCKETS> cutoffIndex{};
+        ndarray<uint64_t, TIMER_NB> cycles{};
+
+        SearchStats& operator+=(const SearchStats& other);
+
+        // A few "info string stats ..." lines
+        void report(std::ostream& output) const;
+};
+
+#if ATHENA_STATS
+
+inline uint64_t readCycles() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+// Adds the cycles spent in its scope to a counter
+class ScopedCycles
+{
+    private:
+
+        uint64_t& counter;
+        uint64_t start;
+
+    public:
+
+        explicit ScopedCycles(uint64_t& counter_) noexcept : counter(counter_), start(readCycles()) {}
+        ~ScopedCycles() noexcept { counter += readCycles() - start; }
+};
+
+#define STATS(expr) (expr)
+#define STATS_CONCAT_(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_(a, b)
+#define STATS_TIMER(thread, timer) ScopedCycles STATS_CONCAT(statsTimer, __LINE__)((thread).stats.cycles[timer])
+
+#else
+
+#define STATS(expr) ((void)0)
+#define STATS_TIMER(thread, timer) ((void)0)
+
+#endif
+
+} // namespace athena
+
+#endif // #ifndef STATS_H
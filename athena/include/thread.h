@@ -1,12 +1,21 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <vector>
 #include "chess.h"
+#include "stats.h"
 
 namespace athena
 {
 
+class NNUE;
+class TraceRing;
+struct SearchControl;
+
+// Plies of principal variation the search keeps
+constexpr int MAX_PV = 64;
+
 class Thread
 {
 public:
@@ -14,6 +23,20 @@ public:
     Move move{};                        // best root move
     std::uint64_t nodes = 0;            // total nodes visited in this search
     std::vector<Move> pv;               // principal variation line
+    NNUE* nnue = nullptr;               // network for evaluation, kept in step with the search
+    std::uint64_t evals = 0;            // hybrid evaluations with a network loaded
+    std::uint64_t skips = 0;            // of which answered by material alone
+#if ATHENA_STATS
+    SearchStats stats;                  // search counters, see stats.h
+#endif
+    TraceRing* trace = nullptr;         // search trace queue, if one is being written
+    SearchControl* control = nullptr;   // stop flag and limits, if the search can be interrupted
+    std::vector<Move> excluded;         // root moves skipped, lines already found in MultiPV
+    std::vector<Move> rootOrder;        // root moves tried first, best lines of the last iteration
+
+    // Triangular PV table: pvTable[play] is the best line found from that ply
+    std::array<std::array<Move, MAX_PV>, MAX_PV> pvTable{};
+    std::array<int, MAX_PV> pvLength{};
 };
 
 } // namespace athena
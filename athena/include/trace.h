@@ -0,0 +1,117 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "chess.h"
+
+namespace athena
+{
+
+// Why a negamax node returned what it did
+enum TraceReason : uint8_t { TraceLeaf, TraceCutoff, TraceAll, TraceCheckmate, TraceStalemate, TraceFifty, TraceRepetition, TRACE_REASON_NB };
+
+// One negamax node, written when the node returns. `node` is the thread's
+// node count on entry, so records sorted by it are in preorder.
+struct TraceRecord
+{
+    uint64_t node;
+    int32_t alpha; // window on entry
+    int32_t beta;
+    int32_t score;
+    Move move;     // best move found, none at leaves
+    uint16_t ply;
+    int8_t depth;
+    TraceReason reason;
+};
+
+// Single producer, single consumer queue between a search thread and the
+// writer. The search never waits: a record that does not fit is dropped
+// and counted.
+class TraceRing
+{
+    private:
+
+        std::unique_ptr<TraceRecord[]> records;
+        std::size_t mask;
+
+        alignas(64) std::atomic<uint64_t> head{0}; // next slot the search fills
+        alignas(64) std::atomic<uint64_t> tail{0}; // next slot the writer reads
+        alignas(64) std::atomic<uint64_t> dropped{0};
+
+    public:
+
+        // Keep every sample-th node no deeper than maxPly, set by Tracer
+        uint64_t sample = 1;
+        int maxPly = MAX_PLY;
+
+        explicit TraceRing(std::size_t capacity);
+
+        inline bool wants(uint64_t node, int ply) const noexcept {
+            return ply <= maxPly && node % sample == 0;
+        }
+
+        inline void push(const TraceRecord& record) noexcept
+        {
+            auto h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) > mask)
+            {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            records[h & mask] = record;
+            head.store(h + 1, std::memory_order_release);
+        }
+
+        // Hands every queued record to `sink`, returns how many there were
+        template <typename Sink>
+        std::size_t drain(Sink&& sink)
+        {
+            auto t = tail.load(std::memory_order_relaxed);
+            auto h = head.load(std::memory_order_acquire);
+            for (auto i = t; i < h; ++i)
+                sink(records[i & mask]);
+            tail.store(h, std::memory_order_release);
+            return h - t;
+        }
+
+        uint64_t droppedCount() const noexcept { return dropped.load(std::memory_order_relaxed); }
+};
+
+// Streams the records of one search as JSON lines (see docs/TRACE.md) from a
+// background thread. start() opens the file and hands out one ring per
+// search thread, stop() drains what is left and closes it.
+class Tracer
+{
+    private:
+
+        std::ofstream file;
+        std::vector<std::unique_ptr<TraceRing>> rings;
+        std::thread writer;
+        std::atomic<bool> running{false};
+
+        std::size_t flush();
+
+    public:
+
+        ~Tracer();
+
+        // Appends a {"fen": ...} line for the searched position to `path`,
+        // throws std::invalid_argument if the file cannot be opened
+        void start(const std::string& path, std::string_view fen, int threads, uint64_t sample, int maxPly);
+
+        // Returns the number of records dropped because a ring was full
+        uint64_t stop();
+
+        TraceRing* ring(int thread) { return rings[thread].get(); }
+};
+
+} // namespace athena
+
+#endif // #ifndef TRACE_H
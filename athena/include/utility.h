@@ -1,7 +1,12 @@
 #ifndef UTILITY_H
 #define UTILITY_H
 
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
 #include <iomanip>
@@ -68,54 +73,154 @@ inline auto concatenate(const std::vector<std::string>& tokens, size_t start, si
     return result;
 }
 
-void fromString(const std::string& str, Position& pos);
+// Longest FEN toString(pos, buffer) can write, board fields included
+constexpr std::size_t MAX_FEN_LENGTH = 576;
+
+// Parses a FEN, throwing std::invalid_argument on malformed fields. pos is
+// only written once the whole string has been read.
+void fromString(std::string_view str, Position& pos);
+
+// Writes the FEN of pos to buffer (MAX_FEN_LENGTH bytes, not terminated)
+// and returns one past the last character written
+char* toString(const Position& pos, char* buffer) noexcept;
 std::string toString(const Position& pos);
 
-inline void fromString(const std::string& str, Square& sq)
+// Next non-empty field of str up to `delimiter`, consumed from str
+inline std::string_view nextToken(std::string_view& str, char delimiter = ' ') noexcept
+{
+    while (!str.empty() && str.front() == delimiter)
+        str.remove_prefix(1);
+
+    // Fields are short, a plain loop beats a memchr call per token
+    std::size_t end = 0;
+    while (end < str.size() && str[end] != delimiter)
+        ++end;
+
+    auto token = str.substr(0, end);
+    str.remove_prefix(end);
+    return token;
+}
+
+// str without leading and trailing blanks
+inline std::string_view trim(std::string_view str) noexcept
+{
+    while (!str.empty() && std::isspace(static_cast<unsigned char>(str.front()))) str.remove_prefix(1);
+    while (!str.empty() && std::isspace(static_cast<unsigned char>(str.back())))  str.remove_suffix(1);
+    return str;
+}
+
+// ASCII case-insensitive equality, e.g. UCI option names
+inline bool iequals(std::string_view a, std::string_view b) noexcept
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+inline void fromString(std::string_view str, int& value)
 {
-    if (str != "-")
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (str.empty() || ec != std::errc() || ptr != str.data() + str.size())
+        throw std::invalid_argument("invalid number: " + std::string(str));
+}
+
+inline void fromString(std::string_view str, Square& sq)
+{
+    if (str == "-")
     {
-        int file = std::tolower(str[0]) - 'a';
-        int rank = std::stoi(str.substr(1)) - 1;
-        sq = static_cast<Square>(rank * FILE_NB + file);
+        sq = OFFBOARD;
+        return;
     }
-    else sq = OFFBOARD;
+
+    int file = str.empty() ? -1 : std::tolower(str[0]) - 'a';
+    int rank = 0;
+    auto [ptr, ec] = std::from_chars(str.data() + std::min<std::size_t>(1, str.size()), str.data() + str.size(), rank);
+
+    if (ec != std::errc() || ptr != str.data() + str.size() || !isValidSquare(rank - 1, file))
+        throw std::invalid_argument("invalid square: " + std::string(str));
+
+    sq = makeSQ(rank - 1, file);
 }
 
-inline void fromString(const std::string& str, GameSetup& setup) {
-    setup = (str == "classic") ? Classic : Modern;
+inline void fromString(std::string_view str, GameSetup& setup)
+{
+    if      (str == "classic") setup = Classic;
+    else if (str == "modern")  setup = Modern;
+    else throw std::invalid_argument("invalid setup: " + std::string(str));
 }
 
-inline void fromString(const std::string& str, Color& color) noexcept {
-    color = COLOR_TABLE[std::tolower(str[0]) - 'a'];
+// Letters are folded to lower case by hand, std::tolower goes through the locale
+inline void fromString(std::string_view str, Color& color) noexcept {
+    int i = str.empty() ? -1 : (str[0] | 0x20) - 'a';
+    color = (0 <= i && i < 26) ? COLOR_TABLE[i] : None;
 }
 
-inline void fromString(const std::string& str, Piece& piece) noexcept {
-    piece = PIECE_TABLE[std::tolower(str[0]) - 'a'];
+inline void fromString(std::string_view str, Piece& piece) noexcept {
+    int i = str.empty() ? -1 : (str[0] | 0x20) - 'a';
+    piece = (0 <= i && i < 26) ? PIECE_TABLE[i] : Empty;
 }
 
-inline void fromString(const std::string& str, PieceClass& pc)
+inline void fromString(std::string_view str, PieceClass& pc) noexcept
 {
-    auto piece = PIECE_TABLE[std::tolower(str[1]) - 'a'];
-    auto color = COLOR_TABLE[std::tolower(str[0]) - 'a'];
+    Color color = None;
+    Piece piece = Empty;
+    if (str.size() == 2)
+    {
+        fromString(str.substr(0, 1), color);
+        fromString(str.substr(1, 1), piece);
+    }
     pc = PieceClass(piece, color);
 }
 
-inline void fromString(const std::string& str, BitBoard& castle, GameSetup setup, Side side)
+// Splits move text such as "k13k14q" into its squares and the promotion
+// piece, Empty when there is none
+inline void fromString(std::string_view str, Square& source, Square& target, Piece& evolve)
+{
+    auto squareEnd = [&](std::size_t from) {
+        auto i = from + 1;
+        while (i < str.size() && std::isdigit(static_cast<unsigned char>(str[i]))) ++i;
+        return std::min(i, str.size());
+    };
+
+    auto middle = squareEnd(0);
+    auto end = squareEnd(middle);
+
+    fromString(str.substr(0, middle), source);
+    fromString(str.substr(middle, end - middle), target);
+
+    evolve = Empty;
+    if (end < str.size())
+    {
+        fromString(str.substr(end), evolve);
+        if (str.size() != end + 1 || evolve == Empty || evolve == King || evolve == Pawn)
+            throw std::invalid_argument("invalid promotion: " + std::string(str));
+    }
+}
+
+inline void fromString(std::string_view str, uint8_t& castle, Side side)
 {
+    if (str.size() != COLORS.size())
+        throw std::invalid_argument("invalid castle rights: " + std::string(str));
+
     for (auto color: COLORS)
-        if (str[color] == '1') castle |= RIGHTS[setup][color][side];
+        if (str[color] == '1') castle |= castleBit(color, side);
 }
 
-inline void fromString(const std::string& str, int& clock) {
-    clock = std::stoi(str);
+// Players still in the game, e.g. "1011" once Blue is out
+inline void fromString(std::string_view str, uint8_t& alive)
+{
+    if (str.size() != COLORS.size() || str.find_first_not_of("01") != std::string_view::npos || str == "0000")
+        throw std::invalid_argument("invalid alive players: " + std::string(str));
+
+    alive = 0;
+    for (auto color: COLORS)
+        if (str[color] == '1') alive |= aliveBit(color);
 }
 
-inline void fromString(const std::string& str, ndarray<Square, COLOR_NB - 1>& enpass)
+inline void fromString(std::string_view str, ndarray<Square, COLOR_NB - 1>& enpass)
 {
-    auto tokens = tokenize(str, ',');
     for (auto color: COLORS)
-        fromString(tokens[color], enpass[color]);
+        fromString(nextToken(str, ','), enpass[color]);
 }
 
 inline std::string toString(Piece piece)
@@ -155,19 +260,42 @@ inline std::string toString(PieceClass pc)
     return str;
 }
 
+// Longest move text, e.g. "k13k14q"
+constexpr std::size_t MAX_MOVE_LENGTH = 7;
+
+// Writes sq to buffer and returns one past the last character written
+inline char* toString(Square sq, char* buffer) noexcept
+{
+    if (sq == OFFBOARD)
+    {
+        *buffer++ = '-';
+        return buffer;
+    }
+
+    *buffer++ = static_cast<char>('a' + fileSQ(sq));
+    return std::to_chars(buffer, buffer + 2, rankSQ(sq) + 1).ptr;
+}
+
+// Writes move to buffer (MAX_MOVE_LENGTH bytes, not terminated) and
+// returns one past the last character written
+inline char* toString(Move move, char* buffer) noexcept
+{
+    buffer = toString(move.source(), buffer);
+    buffer = toString(move.target(), buffer);
+    if (move.nature() == Evolve) *buffer++ = "knbrqp"[move.evolve().piece()];
+    return buffer;
+}
+
 inline std::string toString(Square sq)
 {
-    if (sq == OFFBOARD) return "-";
-    return std::string(1, 'a' + fileSQ(sq)) + std::to_string(rankSQ(sq) + 1);
+    char buffer[3];
+    return std::string(buffer, toString(sq, buffer));
 }
 
 inline std::string toString(Move move)
 {
-    std::string str = "";
-    str += toString(move.source());
-    str += toString(move.target());
-    if (move.nature() == Evolve) str += toString(move.evolve().piece());
-    return str;
+    char buffer[MAX_MOVE_LENGTH];
+    return std::string(buffer, toString(move, buffer));
 }
 
 inline std::string toString(int clock) noexcept {
@@ -178,11 +306,19 @@ inline std::string toString(GameSetup setup) noexcept {
     return (setup == Classic) ? "classic" : "modern";
 }
 
-inline std::string toString(const BitBoard& castle, GameSetup setup, Side side) noexcept
+inline std::string toString(uint8_t castle, Side side) noexcept
 {
     std::string str = "";
     for (auto color: COLORS)
-        str += (hasCastle(castle, RIGHTS[setup][color][side]) ? "1" : "0");
+        str += ((castle & castleBit(color, side)) ? "1" : "0");
+    return str;
+}
+
+inline std::string toString(uint8_t alive) noexcept
+{
+    std::string str = "";
+    for (auto color: COLORS)
+        str += ((alive & aliveBit(color)) ? "1" : "0");
     return str;
 }
 
@@ -314,8 +450,11 @@ inline void print(const Position& pos, bool print_fen, bool use_ascii_pieces)
     std::cout << std::left << std::setw(KEY_WIDTH) << "Clock:" << toString(gs.clock) << std::endl;
 
     // Castling
-    std::cout << std::left << std::setw(KEY_WIDTH) << "KingSide:" << toString(gs.castle, pos.setup, KingSide) << std::endl;
-    std::cout << std::left << std::setw(KEY_WIDTH) << "QueenSide:" << toString(gs.castle, pos.setup, QueenSide) << std::endl;
+    std::cout << std::left << std::setw(KEY_WIDTH) << "KingSide:" << toString(gs.castle, KingSide) << std::endl;
+    std::cout << std::left << std::setw(KEY_WIDTH) << "QueenSide:" << toString(gs.castle, QueenSide) << std::endl;
+
+    // Players
+    std::cout << std::left << std::setw(KEY_WIDTH) << "Alive:" << toString(gs.alive) << std::endl;
 
     // En Passant
     std::cout << std::left << std::setw(KEY_WIDTH) << "Enpassant:";
@@ -1,9 +1,91 @@
 #ifndef ZOBRIST_H
 #define ZOBRIST_H
 
+#include "chess.h"
+#include "random.h"
+#include "position.h"
+
 namespace athena
 {
 
+struct ZobristKeys
+{
+    ndarray<uint64_t, PIECECLASS_NB, SQUARE_NB> piece;
+    ndarray<uint64_t, COLOR_NB - 1> turn;
+    ndarray<uint64_t, 256> castle; // per castling-rights mask
+    ndarray<uint64_t, SQUARE_NB> enpass;
+    ndarray<uint64_t, ALL_ALIVE + 1> alive; // per alive-players mask
+};
+
+// Empty squares, stones, OFFBOARD, no castling rights and everyone alive
+// hash to zero so updates need no branches
+constexpr ZobristKeys ZOBRIST = []
+{
+    ZobristKeys keys{};
+    PRNG rng(1070372);
+
+    for (auto color : COLORS)
+        for (auto piece : PIECES)
+            for (auto sq : VALID_SQUARES)
+                keys.piece[PieceClass(piece, color)][sq] = rng.next();
+
+    for (auto color : COLORS)
+        keys.turn[color] = rng.next();
+
+    for (int mask = 1; mask < 256; ++mask)
+        keys.castle[mask] = rng.next();
+
+    for (auto sq : VALID_SQUARES)
+        keys.enpass[sq] = rng.next();
+
+    for (int mask = 0; mask < ALL_ALIVE; ++mask)
+        keys.alive[mask] = rng.next();
+
+    return keys;
+}();
+
+// Full key of the position from scratch, makemove keeps it incrementally
+uint64_t computeHash(const Position& pos);
+
+// Every reversible piece move (a piece going between two squares on an
+// empty board) keyed by the hash change it causes, turn included. Two
+// slots per key in Kennedy's cuckoo scheme, so a lookup is two probes.
+// Filled at startup, used to find a move back to an earlier position.
+class CuckooTable
+{
+    public:
+
+        static constexpr std::size_t SIZE = 1 << 16;
+
+        struct Entry
+        {
+            uint64_t key = 0;
+            Square a = OFFBOARD, b = OFFBOARD;
+            Piece line = Empty; // Rook or Bishop line a slider needs clear, Empty for jumpers
+        };
+
+        static constexpr std::size_t h1(uint64_t key) noexcept { return key & (SIZE - 1); }
+        static constexpr std::size_t h2(uint64_t key) noexcept { return (key >> 16) & (SIZE - 1); }
+
+        CuckooTable();
+
+        inline const Entry* find(uint64_t key) const noexcept
+        {
+            if (entries[h1(key)].key == key) return &entries[h1(key)];
+            if (entries[h2(key)].key == key) return &entries[h2(key)];
+            return nullptr;
+        }
+
+        std::size_t count() const noexcept { return size; }
+
+    private:
+
+        std::unique_ptr<Entry[]> entries = std::make_unique<Entry[]>(SIZE);
+        std::size_t size = 0;
+};
+
+extern const CuckooTable CUCKOO;
+
 } // namespace athena
 
-#endif // #ifndef ZOBRIST_H
\ No newline at end of file
+#endif // #ifndef ZOBRIST_H
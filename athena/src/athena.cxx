@@ -3,6 +3,14 @@
 int main(int argc, char* argv[])
 {
     athena::Engine engine;
+
+    // A command on the command line runs once, e.g. "athena perft-suite suite.epd"
+    if (argc > 1)
+    {
+        engine.execute(argc, const_cast<const char**>(argv));
+        return engine.exitStatus();
+    }
+
     engine.launch();
-    return 0;
+    return engine.exitStatus();
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "bench.h"
+#include "search.h"
+#include "utility.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace athena
+{
+
+// Both start positions, then games a few to a hundred plies in with every
+// king still on the board. Positions whose quiescence search explodes at
+// low depth were left out so a default run takes seconds.
+constexpr std::string_view BENCH_POSITIONS[] =
+{
+    "classic R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bq,bp,10,gp,gk,bk,bp,10,gp,gq,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr",
+    "modern R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bk,bp,10,gp,gq,bq,bp,10,gp,gk,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr",
+    "classic r 0 0100 0100 -,-,-,- rr,rn,6,rp,2,rp,rp,7,rk,rn,rp,1,br,1,bp,1,rp,5,rr,3,bn,3,bp,8,gk,17,bp,8,gp,1,bk,bp,2,bp,6,gp,1,gq,bb,11,gp,15,br,1,yp,bp,6,yp,1,gp,gr,4,yk,1,gn,2,yp,1,yp,1,yp,2,yr,yn,6",
+    "modern y 0 0000 0000 -,-,k13,- 2,rk,7,rp,2,rp,6,rp,rn,4,gr,11,bn,15,bp,7,gp,gp,2,bk,bp,11,gk,10,br,1,gp,4,bp,13,yp,6,gp,6,bp,5,yp,2,yn,gr,3,yk,yp,2,yp,2,yp,10,yb,1,yr",
+    "classic y 1 0000 0000 -,-,-,- 5,rk,2,bn,3,rp,rp,5,rp,1,rn,2,br,bp,23,gp,17,bk,1,rn,6,gp,2,gk,1,bp,10,gb,1,bb,9,gp,3,br,bp,10,gp,2,bp,3,yp,1,yr,3,gp,1,gr,9,yp,yk,yp,1,yp,yp,2,yn,3,yb,2",
+    "classic r 1 0000 0000 -,-,-,- rk,2,rr,2,rn,1,rp,rp,br,1,rp,rp,5,gr,16,gp,1,bn,bp,7,rp,4,bb,13,bk,bp,13,bp,9,gp,gk,1,br,1,bp,10,gr,9,yp,16,gp,6,yn,6,yk,yp,1,yp,7,yr",
+    "modern g 0 0000 0000 -,-,-,- 6,rr,3,bb,12,rk,2,rp,5,rp,1,rp,1,gp,gr,2,rr,14,bp,11,bp,13,bk,8,gn,4,bp,bn,7,gp,2,gk,1,bp,11,gn,3,yp,3,yk,3,gp,6,yp,4,yp,3,yp,1,yp,5,yr,1,yr",
+    "classic b 0 0000 1000 -,-,-,- rr,rn,2,rk,5,rp,rp,1,rp,rp,10,bp,bn,rp,rp,24,bk,54,yq,11,yb,1,br,1,bn,yp,1,yp,6,gk,2,rq,9,yp,1,yk,6,yr,3",
+    "classic b 3 0100 1110 -,-,-,- rr,rn,1,rq,rk,4,rp,rp,1,rp,rp,8,rp,1,br,bp,1,rp,2,rp,2,rn,4,bn,bp,11,gn,1,bp,8,rr,2,gk,bq,1,bp,9,gp,1,bk,1,bp,12,bp,8,gp,3,bn,13,br,2,bp,5,yb,gp,2,gr,8,yp,bb,yp,3,yp,yp,1,yn,yb,yk,2,yn,yr",
+    "modern g 0 0001 0011 -,-,-,- rr,rn,3,rr,2,rp,3,rk,5,rp,rp,2,rp,3,br,bp,rp,6,gp,1,gr,1,bp,12,bb,1,bp,11,bk,11,gp,13,gb,gk,1,bp,9,gn,gp,2,bb,10,gp,1,br,bp,2,yp,2,yp,3,gp,1,gr,10,yp,yp,yn,yp,yp,yp,1,yn,1,yk,3,yr",
+    "classic y 1 0000 0000 -,-,e13,- 4,rk,1,rr,3,rp,2,rp,rp,2,gb,13,rp,2,rp,1,gp,gr,bn,bp,8,gp,2,gn,bb,9,gp,1,gk,2,bp,24,gn,1,bk,bp,10,gp,gb,bn,bp,9,gp,5,br,3,yp,4,gp,gr,7,yp,1,yp,yp,1,yk,yp,yp,5,yr,1,yn,yr",
+    "classic g 0 1000 1000 i4,-,-,- rr,1,rb,rq,rk,1,rn,rr,rp,rp,rp,rp,3,rp,15,rp,rp,3,gp,gr,1,bp,10,gp,1,bb,bp,bn,9,gp,gb,bq,bp,8,gp,4,bp,10,gp,gk,bk,1,rb,bp,4,gn,1,gp,2,gb,1,bb,bp,9,gp,gn,br,3,yp,3,yp,1,yp,2,gr,2,yp,4,yp,yp,1,yk,yp,yp,3,yr,yn,3,yb,yn,yr",
+    "classic b 1 0100 0000 -,-,-,- 3,rq,1,rb,5,rk,rp,1,rp,2,rp,8,rb,5,rp,3,gp,yb,1,bp,4,rn,3,rr,15,gp,12,gp,2,bk,1,bp,13,bp,8,gp,1,gk,bn,1,yn,9,gp,1,br,2,bp,15,yp,gb,1,yp,1,yk,yp,yp,1,yp,1,yr,4,yb,yn,yr",
+    "modern y 1 0000 0000 -,-,-,- 1,rn,rb,2,rb,1,rr,5,rk,rp,5,rp,2,rp,br,bp,10,gp,gr,bn,7,rn,2,gp,1,gn,1,bk,25,gk,10,gp,4,bp,bn,rr,7,gp,3,bp,11,gn,br,12,bq,1,yp,yp,yp,1,yp,yp,6,yp,2,yr,yn,1,yk,1,yr,2",
+    "modern b 0 0000 0000 -,-,e13,- 11,rk,6,rp,13,br,5,bn,bp,19,bq,1,gp,2,gp,1,bk,14,bp,11,gk,bb,10,gp,3,bp,11,gn,1,yb,1,yp,7,gp,1,gr,2,yn,2,yp,3,yp,yp,yk,3,yp,1,yr,6",
+    "modern r 0 1010 1010 -,-,-,- rr,3,rk,1,rn,rr,rp,1,rp,1,rb,rp,rp,8,rp,br,2,bp,1,rn,rp,5,gp,gr,bn,1,bp,9,gp,gn,1,bp,10,gp,4,bp,6,gp,gk,3,bk,9,gn,3,bp,10,gp,gb,2,bp,2,yp,8,br,bp,10,gp,gr,yn,5,yp,1,bn,yp,2,yp,yp,1,yp,yr,1,yb,yk,2,yn,yr",
+    "modern y 0 0000 0000 -,-,-,- rr,rn,3,rb,1,rr,rp,3,rq,1,rp,1,gb,8,bp,3,rp,4,rk,1,gp,gr,9,rn,rp,1,gp,2,bp,8,gp,2,gb,bk,2,bp,6,gn,1,gp,gk,bq,bp,8,gp,3,bb,bp,10,gp,1,bn,bp,10,gp,13,gp,gr,7,yp,yp,yp,yp,yp,yn,yp,yp,2,yr,yb,1,yk,yr,2",
+    "modern r 0 0000 0010 -,-,-,- rr,3,rq,1,rn,3,rp,1,rk,rp,11,yr,4,rp,7,bn,9,rr,12,gp,gn,5,bp,1,yn,7,gp,3,rn,9,gk,1,yb,bp,bk,7,gp,3,bn,1,bp,9,gp,gn,5,yp,yp,5,gp,gr,5,yp,8,yp,yp,1,yn,1,yk,1,yb,1,yr",
+    "modern g 2 0000 0000 -,-,-,- 1,gb,3,rk,15,rp,6,br,1,rp,8,bp,5,rp,3,gp,1,gn,bb,2,bp,1,rp,6,gp,1,bk,1,bp,7,gn,4,yb,10,gp,1,bb,2,bp,8,gp,1,bn,bp,18,yk,6,gk,5,yp,yp,6,yq,1,yp,8",
+    "modern g 0 0000 0000 -,-,-,- 11,rn,4,rp,1,rp,1,rk,3,br,bp,10,gp,2,bp,13,bk,13,bn,13,bp,10,gp,gk,1,bn,8,bb,5,gr,19,br,7,yp,yp,10,yk,9",
+    "modern g 0 0100 0100 -,-,-,- rr,2,rk,1,rb,rn,rr,rp,1,rp,1,rp,1,rp,rp,bb,rp,6,br,bp,10,gp,gr,8,rp,3,gp,gn,1,bp,bn,9,gp,gb,bk,2,bp,8,gp,2,bp,11,gq,bb,bp,9,gp,gk,2,bp,10,gb,1,br,bp,1,yp,yk,yp,5,gp,gp,gr,9,yp,1,yp,yp,yp,yp,yr,yr,yn,yb,1,yq,yb,yn,1",
+    "modern g 1 0001 0011 i4,-,-,- 3,rk,11,rp,1,rp,rn,5,rr,5,rp,rp,2,gp,2,gr,1,bp,8,gp,2,gn,yr,8,gp,5,bp,bk,7,gp,6,bp,2,yn,5,gn,gk,1,bp,10,gp,25,gp,2,gr,1,yp,4,yp,3,yp,yq,yp,yp,1,yp,3,yk,3,yr",
+    "classic b 0 0010 0000 -,-,-,- 7,rr,3,rn,1,rk,1,rp,4,rp,1,rp,rn,11,gn,gp,3,bp,rp,8,gp,gr,26,gb,gk,1,rb,1,bp,6,yr,17,bk,11,gp,gr,br,bp,1,yp,yp,7,gp,11,yp,yn,yn,1,yp,1,yr,2,yk,4",
+    "classic g 0 0010 0000 -,-,-,- 2,rn,4,rr,3,rn,yb,1,rp,rp,4,rk,6,rp,8,gp,gr,11,gp,4,bp,7,gp,gn,25,gp,2,gn,2,bk,9,gp,gk,gb,10,gp,2,gr,3,bp,yp,yp,yp,5,gp,7,gb,1,yp,6,yp,yr,yn,1,yk,4",
+    "classic g 0 0000 0000 -,-,-,- 6,rn,bn,1,rp,rk,4,gn,13,rp,6,gp,18,rn,5,gr,gp,2,gk,3,bp,25,bp,bk,9,gp,1,bn,11,gp,gn,9,yb,4,yn,yp,yp,3,yp,1,yp,6,yp,yr,2,yk,2,yr,1",
+    "classic y 1 0000 0000 -,-,-,- rr,5,rk,1,rn,1,rp,2,rp,1,rp,rp,rr,3,rn,1,bb,br,bp,2,bq,2,rp,4,gp,gr,bk,bp,9,gp,1,gn,1,bp,10,gp,3,bp,7,gp,4,bp,1,yn,8,gk,2,bp,10,gp,gb,bn,10,gp,7,bp,1,yp,1,yp,gn,1,gp,gr,2,yp,5,yp,2,gq,1,yp,2,yr,2,yk,4",
+    "modern b 0 0000 0000 -,-,-,- 1,rn,2,rk,1,rr,7,rp,3,rp,11,rp,9,bp,3,rp,5,gp,gn,1,bp,10,gp,1,bn,9,gp,2,gq,bk,11,gp,1,bb,bp,gb,6,gk,17,gn,rr,18,yn,10,gr,2,yk,1,yn,2",
+    "modern r 0 1111 1111 f4,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,1,rp,rp,rp,rp,rp,rp,8,br,bp,2,rp,7,gp,gr,bn,bp,10,gp,1,bb,bp,9,gn,gp,gb,bk,bp,10,gp,gq,bq,bp,10,gp,gk,bb,bp,10,gp,gb,bn,1,bp,9,gp,gn,br,bp,10,gp,gr,yp,8,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr",
+    "modern g 2 0100 1100 -,-,-,- rr,1,rb,rq,rk,1,rn,2,rp,rp,1,rp,4,rn,6,br,bp,1,rp,4,rp,6,bp,7,rp,1,gp,1,gn,bb,bp,10,gp,gq,bk,bn,10,gp,3,bp,bp,8,gp,gk,11,gp,13,gp,1,gn,br,bp,9,gb,3,yp,yp,1,yk,yp,2,yp,3,yn,2,yp,yr,yn,4,yr,1",
+    "classic y 0 0010 0000 k4,-,f13,- rr,rn,3,rb,6,rk,rp,2,rp,rp,6,br,bp,4,rp,2,rp,1,rp,1,yr,bn,bp,24,gp,gb,12,gp,13,gn,2,bk,bp,9,gk,2,bp,2,bb,3,yp,1,gp,3,br,bp,2,yp,8,gr,8,yp,1,yp,yp,4,yr,yn,yb,yk,4",
+    "modern r 0 0000 0000 -,d10,-,- 3,rk,rr,3,rp,rp,rn,2,rp,1,rp,4,rp,3,br,2,bp,12,bp,6,gn,5,bp,8,gp,2,gk,bk,25,gp,4,bp,7,gn,gp,gb,br,1,yr,9,gp,2,yn,7,yp,gb,gp,1,gr,2,yp,4,yp,yp,1,yk,5,yr,7",
+    "modern b 0 0000 0000 -,-,-,- 1,rr,2,rk,5,rp,6,rp,2,rp,6,rp,5,rp,1,gp,gr,15,br,bk,1,bp,8,gp,11,gn,4,bp,11,gk,3,bp,8,gp,4,bp,5,yn,1,gp,3,bp,3,gr,2,yp,6,yp,4,yp,1,yk,2,gb,3,yp,7,yr",
+    "classic b 0 0000 0000 -,-,-,- 2,rn,13,bn,1,rp,2,rk,1,rp,4,bp,25,bp,6,gp,4,br,14,bn,13,bk,2,bp,6,gk,9,yp,3,gp,3,bp,1,yp,4,yp,12,gb,1,rb,yp,yp,4,yr,yn,2,yk,3",
+    "classic y 0 0111 1101 -,-,-,- rr,rn,rb,1,rk,rb,rn,1,rp,rp,rp,rp,1,rp,rp,rr,8,br,bp,8,rp,1,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,1,bq,bp,8,gp,2,gk,bk,2,bp,8,gp,rq,3,bp,8,gp,gb,bn,bp,10,gp,gn,br,1,bp,9,gp,gr,5,yn,2,yp,yp,yp,gb,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,1,yr",
+    "classic g 0 0000 0000 -,-,-,- 6,rn,rr,1,bb,rk,4,rp,4,rp,rp,2,br,1,bp,rp,5,rp,2,gp,gr,13,gn,2,bp,12,bp,11,gk,1,bn,9,gp,2,bk,4,yn,5,gn,yp,1,br,bp,15,bp,1,yp,6,gp,gr,3,yp,4,yp,yp,2,yp,3,yr,yn,2,yk,yb,2",
+    "modern g 0 0000 0000 -,-,-,- 1,rn,rb,2,rb,1,rr,2,rp,1,rq,1,rp,4,rk,4,br,bp,9,gn,1,gr,3,bp,7,gp,19,bp,10,bk,bp,2,bn,5,gp,2,gk,1,bp,9,gn,13,gp,2,br,bp,1,yp,11,yp,yk,3,yp,gp,2,yp,4,yp,2,yr,4,yr",
+    "modern y 0 0000 0000 -,-,-,- rk,2,rr,3,rr,2,rp,3,rp,5,rp,rn,2,br,bp,1,rp,2,rp,5,gp,gr,bn,bk,6,rp,3,gp,gn,10,rp,1,gp,2,bp,8,gk,3,bq,1,bp,14,bp,23,gn,9,yp,9,gb,bb,4,yb,yp,yk,2,yr,7",
+    "classic g 0 0000 0000 -,-,-,- 1,rn,rb,rq,2,rk,2,rp,5,rn,2,rp,2,rp,2,yb,bp,4,rp,rp,gr,28,gk,5,bp,22,gp,3,bk,7,br,1,gp,6,yp,2,yp,1,gp,4,gn,11,gp,1,gr,2,yp,2,yp,6,yp,2,yp,1,yn,yk,3,yn,yr",
+    "modern y 0 0000 0000 i4,-,-,- 2,rq,1,rk,1,rn,rr,2,rp,rp,6,rn,4,rp,4,rp,2,rp,3,gn,17,bp,7,gk,9,gr,10,bk,23,gp,gb,3,bp,8,gr,3,bn,8,gp,4,yk,yp,1,yn,yp,4,yn,yp,yp,1,yp,5,yb,1,yr",
+    "modern r 1 0000 0001 -,-,-,- 1,rn,2,rk,1,bq,3,rp,6,rp,2,rp,3,rq,10,gp,1,gr,bn,9,gp,4,bp,8,gp,18,bk,10,gn,gk,1,bp,gb,7,gp,2,gr,14,br,bp,14,yp,1,yp,yp,yp,4,yp,5,yn,1,yk,2,yn,1",
+    "modern g 1 0000 0000 -,-,-,- rr,1,rk,5,rp,1,rp,rp,3,rr,4,rp,rp,3,bp,1,bp,7,rn,2,yr,14,bp,10,gp,1,bk,25,gp,4,bp,7,gk,3,bp,10,gb,gn,12,br,4,yp,1,yp,2,yp,1,yk,5,bb,7",
+    "classic y 1 0010 0000 -,-,-,- 13,rk,7,rn,8,rp,4,gk,12,gp,6,rr,7,gp,24,yb,17,gp,gn,1,bk,bn,14,yp,3,yp,13,yp,1,yr,6,yr,2,yk,4",
+    "modern b 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,1,rr,1,rp,rp,rp,rp,rp,rp,rp,8,br,bp,1,rp,2,rn,5,gp,gr,bn,bp,10,gp,gn,1,bp,10,gp,gb,bk,2,bp,8,gp,1,bq,bp,9,gp,1,gk,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,8,yp,1,gp,gr,8,yp,yp,yp,yp,gq,yp,yp,1,yr,yn,yb,yk,1,yb,yn,yr",
+    "modern g 0 0010 0010 -,-,-,- rr,5,rn,1,rp,2,rk,1,rp,11,br,5,rp,3,gp,1,gr,bn,bp,8,rr,15,rb,gb,1,bk,2,bp,5,gp,4,yb,13,bp,8,gp,1,gk,22,yn,4,gp,gr,3,yp,yp,3,yp,1,yp,2,yp,1,yp,yr,2,yk,3,yr",
+    "classic b 0 0000 0000 -,-,f13,- 1,rn,rb,4,rr,2,rk,4,rp,rp,1,rp,12,rp,6,bn,3,bp,7,gp,gn,3,bp,7,gp,1,gk,1,bp,7,rp,gp,3,bk,2,bp,7,gp,2,bb,13,bn,bp,13,br,2,yp,4,yp,gp,14,yp,1,yp,1,yp,1,yn,1,yk,3,yr",
+    "classic r 0 0000 0000 -,-,-,- 9,rp,rp,rk,rn,10,rp,br,1,bp,rp,3,rp,3,gp,gk,1,bn,bp,4,rp,4,gp,11,rp,5,bk,7,gp,16,gp,13,gr,4,yp,10,br,2,bp,1,yp,1,yp,1,yp,1,gp,2,yn,2,yp,9,rr,1,yp,2,yb,yk,1,yr,2",
+    "modern r 0 0000 0000 -,-,-,- rr,3,rk,1,rr,3,rp,6,rp,6,br,1,bp,rp,7,gp,2,bn,2,bp,6,rp,3,bk,1,bp,2,bp,3,yr,gp,15,gp,3,bp,10,gr,3,bp,8,gp,5,bp,7,gk,gn,2,bn,3,yn,17,yp,2,yp,5,yk,4",
+    "modern b 0 1110 1101 l4,-,-,- rr,rn,1,rq,rk,1,rn,rr,rp,1,rp,rp,rp,4,rp,6,br,bp,6,rp,rp,rp,1,gp,gr,bn,bb,11,gn,1,bp,10,gp,1,bk,11,gp,gq,bq,bp,10,gp,gk,bb,bp,9,gp,1,gb,1,bp,9,gp,1,gn,br,bp,5,yp,3,gp,1,gr,9,yp,yp,yp,1,yp,yp,yp,yr,yn,yn,yk,yq,yr,2",
+    "modern b 0 0000 0000 -,-,-,- 4,rr,rb,rn,rr,rp,rp,2,rp,rk,rp,1,rn,4,rp,2,br,2,bp,6,rp,1,gp,yb,bn,bp,3,rp,3,rb,5,bk,10,gp,4,bp,10,bq,bp,8,yb,2,gk,1,bp,10,gp,1,bn,9,gp,3,br,1,bp,4,bp,3,gp,gr,9,yp,1,yp,yk,1,yp,yp,yp,yr,yn,2,yq,yr,2",
+    "classic g 0 0000 0010 -,-,-,- rr,rn,6,rp,1,rp,1,rk,10,rp,4,rp,1,rp,2,rp,2,gp,gr,bn,22,gp,16,gk,1,bk,1,bp,7,gp,5,bp,8,gp,12,gp,15,gq,gr,2,yq,yp,1,yp,2,yp,1,yp,4,yp,3,yk,2,yn,yr"
+};
+
+uint64_t runBench(std::ostream& output, int depth, int threads)
+{
+    constexpr std::size_t size = std::size(BENCH_POSITIONS);
+
+    struct Result
+    {
+        uint64_t nodes;
+        double seconds;
+#if ATHENA_STATS
+        SearchStats stats;
+#endif
+    };
+    std::vector<Result> results(size);
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Whole positions are handed out to threads, each with its own Thread
+    // and no network so the node counts do not depend on the schedule
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]()
+    {
+        for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < size; )
+        {
+            Position pos;
+            fromString(BENCH_POSITIONS[i], pos);
+
+            Thread thread;
+            auto begin = std::chrono::high_resolution_clock::now();
+            negamax(pos, thread, -SCORE_INFINITY, SCORE_INFINITY, depth, 0);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            std::chrono::duration<double> elapsed = end - begin;
+            results[i].nodes = thread.nodes;
+            results[i].seconds = elapsed.count();
+#if ATHENA_STATS
+            results[i].stats = thread.stats;
+#endif
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    double totalTime = elapsed.count();
+
+    output << std::setw(10) << "position"
+           << std::setw(15) << "nodes"
+           << std::setw(15) << "time (s)" << "\n";
+
+    output << std::string(40, '-') << "\n";
+
+    uint64_t totalNodes = 0;
+    output << std::fixed << std::setprecision(6);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        totalNodes += results[i].nodes;
+        output << std::setw(10) << i + 1
+               << std::setw(15) << results[i].nodes
+               << std::setw(15) << results[i].seconds << "\n";
+    }
+
+    // Wall time, so the nps reflects every thread
+    output << "total: " << totalNodes << " nodes, " << totalTime << " s, "
+           << static_cast<uint64_t>(totalTime > 0 ? totalNodes / totalTime : 0) << " nps" << std::endl;
+
+#if ATHENA_STATS
+    SearchStats stats;
+    for (const auto& result : results) stats += result.stats;
+    stats.report(output);
+#endif
+
+    return totalNodes;
+}
+
+} // namespace athena
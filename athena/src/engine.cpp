@@ -2,8 +2,13 @@
 #include "utility.h"
 #include "movegen.h"
 #include "perft.h"
+#include "bench.h"
 #include "search.h"   // for negamax, SCORE_INFINITY
 #include "thread.h"   // for Thread
+#include "eval.h"     // for NNUE_THRESHOLD
+#include <algorithm>
+#include <bit>
+#include <fstream>
 
 namespace athena
 {
@@ -12,40 +17,6 @@ Engine::Engine() : pos()
 {
     fromString(FEN_MODERN, pos);
 
-    auto* uciCommand = app.add_subcommand("uci", "[UCI] Start UCI protocol and identify the engine")
-        ->callback([this]() { handleUCI(); });
-
-    auto* isreadyCommand = app.add_subcommand("isready", "Ensure engine is fully initialized before continuing")
-        ->callback([this]() { handleIsReady(); });
-
-    auto* setOptionCommand = app.add_subcommand("setoption", "Set an engine option in UCI format")
-        ->callback([this]() { handleSetOption(); });
-
-    setOptionCommand->allow_extras();
-
-    auto* ucinewgameCommand = app.add_subcommand("ucinewgame", "Start a new game")
-        ->callback([this]() { handleUCINewGame(); });
-
-    auto* positionCommand = app.add_subcommand("position", "Position setup and display")
-        ->callback([this]() { handlePosition(); });
-    
-    positionCommand->add_option("mode", position_mode, "Position setup mode")
-        ->required()
-        ->check(CLI::IsMember({"classic", "modern", "fen"}));
-    
-    positionCommand->allow_extras();
-    
-    auto* goCommand = app.add_subcommand("go", "Start a search")
-        ->callback([this]() { handleGo(); });
-    goCommand->allow_extras();  // allow "go depth 1" etc.
-
-
-    auto* stopCommand = app.add_subcommand("stop", "Stop the current search")
-        ->callback([this]() { handleStop(); });
-
-    auto* exitCommand = app.add_subcommand("quit", "Quit the engine")
-        ->callback([this]() { handleQuit(); });
-
     auto* perftCommand = app.add_subcommand("perft", "Run perft to given depth")
         ->callback([this]() { handlePerft(); });
 
@@ -56,6 +27,39 @@ Engine::Engine() : pos()
     perftCommand->add_flag("-f,--full", perft_full, "Show full detailed report");
     perftCommand->add_flag("-s,--split", perft_split, "Show perft per move (split node counts)");
     perftCommand->add_flag("-c,--cumulative", perft_cumulative, "Show cumulative totals at each depth");
+    perftCommand->add_option("-t,--threads", perft_threads, "Threads to count with")
+        ->check(CLI::PositiveNumber);
+    perftCommand->add_option("--hash", perft_hash, "Cache subtree counts in a table of this many MB")
+        ->check(CLI::NonNegativeNumber);
+    perftCommand->add_option("--against", perft_against, "Bisect a divide against a reference trace file");
+    perftCommand->add_flag("--copy-make", perft_copy, "Undo moves by restoring board snapshots");
+
+    auto* suiteCommand = app.add_subcommand("perft-suite", "Check perft counts of every position in a file")
+        ->callback([this]() { handlePerftSuite(); });
+
+    suiteCommand->add_option("input", suite_input, "File of \"<fen> ;D1 <nodes> ;D2 <nodes> ...\" lines")
+        ->required();
+
+    suiteCommand->add_option("-t,--threads", suite_threads, "Positions to run at once")
+        ->check(CLI::PositiveNumber);
+    suiteCommand->add_flag("--csv", suite_csv, "Write CSV instead of JSON");
+    suiteCommand->add_option("-o,--output", suite_output, "Write results to a file instead of stdout");
+
+    auto* benchCommand = app.add_subcommand("bench", "Search the built-in bench positions and report nodes and nps")
+        ->callback([this]() { handleBench(); });
+
+    benchCommand->add_option("depth", bench_depth, "Depth to search every position")
+        ->check(CLI::PositiveNumber);
+    benchCommand->add_option("threads", bench_threads, "Positions to search at once")
+        ->check(CLI::PositiveNumber);
+
+    auto* scoreCommand = app.add_subcommand("score", "Score positions from a file with the NNUE")
+        ->callback([this]() { handleScore(); });
+
+    scoreCommand->add_option("input", score_input, "File with one position per line")
+        ->required();
+
+    scoreCommand->add_option("-o,--output", score_output, "Write scores to a file instead of stdout");
 
     auto* printCommand = app.add_subcommand("print", "Print current position")
         ->callback([this]() { handlePrint(); });
@@ -68,12 +72,19 @@ Engine::Engine() : pos()
 void Engine::launch()
 {
     std::string line;
-    while (true)
+    while (std::getline(std::cin, line))
     {
-        if (!std::getline(std::cin, line)) break;
-        if (line.empty()) continue;
+        // GUIs on Windows end lines with \r\n
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        std::string_view rest = line;
+        if (nextToken(rest).empty()) continue;
+        if (dispatch(line)) continue;
 
-        std::transform(line.begin(), line.end(), line.begin(), ::tolower);
+        // Command-line style commands use the position
+        finish();
+
+        // Everything else is a command-line style command, e.g. "perft 5 -t 4"
         std::vector<std::string> args = tokenize(line);
         args.insert(args.begin(), "athena");
         
@@ -83,6 +94,55 @@ void Engine::launch()
         
         execute(argc, argv.data());
     }
+
+    finish();
+}
+
+bool Engine::dispatch(std::string_view line)
+{
+    using Handler = void (Engine::*)(std::string_view);
+
+    // Commands marked concurrent run while a search does, the others first
+    // wait for it (a ponder or infinite search is stopped)
+    struct Command
+    {
+        std::string_view name;
+        Handler handler;
+        bool concurrent;
+    };
+
+    static constexpr Command UCI_COMMANDS[] =
+    {
+        { "uci",        &Engine::handleUCI,        false },
+        { "isready",    &Engine::handleIsReady,    true  },
+        { "setoption",  &Engine::handleSetOption,  false },
+        { "ucinewgame", &Engine::handleUCINewGame, false },
+        { "position",   &Engine::handlePosition,   false },
+        { "go",         &Engine::handleGo,         false },
+        { "ponderhit",  &Engine::handlePonderHit,  true  },
+        { "stop",       &Engine::handleStop,       true  },
+        { "quit",       &Engine::handleQuit,       false },
+    };
+
+    auto command = nextToken(line);
+
+    for (const auto& [name, handler, concurrent] : UCI_COMMANDS)
+    {
+        if (name != command) continue;
+
+        try
+        {
+            if (!concurrent) finish();
+            (this->*handler)(line);
+        }
+        catch (const std::exception& e) {
+            std::cout << "info string " << e.what() << std::endl;
+            status = 1;
+        }
+        return true;
+    }
+
+    return false;
 }
 
 void Engine::execute(int argc, const char* argv[])
@@ -95,6 +155,19 @@ void Engine::execute(int argc, const char* argv[])
         perft_full = false;
         perft_split = false;
         perft_cumulative = false;
+        perft_threads = 1;
+        perft_hash = 0;
+        perft_against.clear();
+        perft_copy = false;
+
+        suite_output.clear();
+        suite_threads = 1;
+        suite_csv = false;
+
+        bench_depth = 3;
+        bench_threads = 1;
+
+        score_output.clear();
 
         print_config = false;
         print_fen = false;
@@ -104,170 +177,541 @@ void Engine::execute(int argc, const char* argv[])
     } 
     catch (const CLI::ParseError& e) {
         std::cerr << "info string cli invalid command" << std::endl;
+        status = 1;
     } 
     catch (const std::exception& e) {
         std::cout << "info string " << e.what() << std::endl;
+        status = 1;
     }
 }
 
-void Engine::handleUCI()
+void Engine::handleUCI(std::string_view)
 {
     std::cout << "id name Athena" << std::endl;
     std::cout << "id author Ariana Hejazyan" << std::endl;
+    std::cout << "option name EvalFile type string default <empty>" << std::endl;
+    std::cout << "option name NNUEThreshold type spin default " << NNUE_THRESHOLD << " min 0 max " << SCORE_INFINITY << std::endl;
+    std::cout << "option name TraceFile type string default <empty>" << std::endl;
+    std::cout << "option name TraceSample type spin default 1 min 1 max 1000000" << std::endl;
+    std::cout << "option name TraceDepth type spin default " << MAX_PLY << " min 0 max " << MAX_PLY << std::endl;
+    std::cout << "option name Ponder type check default false" << std::endl;
+    std::cout << "option name MultiPV type spin default 1 min 1 max " << MAX_MOVES << std::endl;
     std::cout << "uciok" << std::endl << std::flush;
 }
 
-void Engine::handleIsReady()
+void Engine::handleIsReady(std::string_view)
 {
     std::cout << "readyok" << std::endl << std::flush;
 }
 
-void Engine::handleSetOption()
+void Engine::handleSetOption(std::string_view args)
 {
-    const auto& extras = app.get_subcommand("setoption")->remaining();
-
-    if (extras.size() != 4 || extras[0] != "name" || extras[2] != "value") 
+    // setoption name <name> [value <value>], names may hold spaces and are
+    // matched case-insensitively, values are kept verbatim (file paths)
+    if (nextToken(args) != "name")
         throw std::invalid_argument("expected format: setoption name <name> value <value>");
 
-    const std::string& name  = extras[1];
-    const std::string& value = extras[3];
+    std::string_view name, value;
+    for (auto token = nextToken(args); !token.empty(); token = nextToken(args))
+    {
+        if (token == "value")
+        {
+            value = trim(args);
+            break;
+        }
+        name = name.empty() ? token : std::string_view(name.data(), token.data() + token.size() - name.data());
+    }
 
-    if (name == "debug")
+    if (iequals(name, "debug"))
     {
              if (value == "on" ) debug = true ;
         else if (value == "off") debug = false;
-        else throw std::invalid_argument("invalid debug value: " + value);
+        else throw std::invalid_argument("invalid debug value: " + std::string(value));
+    }
+    else if (iequals(name, "evalfile"))
+    {
+        if (!nnue.load(std::string(value)))
+            throw std::invalid_argument("cannot load network file: " + std::string(value));
+        std::cout << "info string loaded network " << nnue.architecture() << std::endl;
+    }
+    else if (iequals(name, "nnuethreshold"))
+    {
+        int threshold;
+        fromString(value, threshold);
+        if (threshold < 0)
+            throw std::invalid_argument("invalid nnuethreshold value: " + std::string(value));
+        NNUE_THRESHOLD = threshold;
+    }
+    else if (iequals(name, "tracefile"))
+    {
+        trace_file = value == "<empty>" ? "" : value;
+    }
+    else if (iequals(name, "tracesample"))
+    {
+        int sample;
+        fromString(value, sample);
+        if (sample < 1)
+            throw std::invalid_argument("invalid tracesample value: " + std::string(value));
+        trace_sample = sample;
+    }
+    else if (iequals(name, "tracedepth"))
+    {
+        int depth;
+        fromString(value, depth);
+        if (depth < 0 || depth > MAX_PLY)
+            throw std::invalid_argument("invalid tracedepth value: " + std::string(value));
+        trace_depth = depth;
     }
-    else throw std::invalid_argument("unknown option name: " + name);
+    else if (iequals(name, "multipv"))
+    {
+        int lines;
+        fromString(value, lines);
+        if (lines < 1 || lines > MAX_MOVES)
+            throw std::invalid_argument("invalid multipv value: " + std::string(value));
+        multipv = lines;
+    }
+    else if (iequals(name, "ponder"))
+    {
+        // Only tells the engine the GUI may send go ponder, nothing to set
+        if (value != "true" && value != "false")
+            throw std::invalid_argument("invalid ponder value: " + std::string(value));
+    }
+    else throw std::invalid_argument("unknown option name: " + std::string(name));
 }
 
-void Engine::handleUCINewGame()
+void Engine::handleUCINewGame(std::string_view)
 {
-    // currently a stub
+    position_setup.clear();
 }
 
-void Engine::handlePosition()
+void Engine::handlePosition(std::string_view args)
 {
-    auto* positionCommand = app.get_subcommand("position");
-    std::vector<std::string> extras = positionCommand->remaining();
-    
-    std::string fen;
-    if (position_mode == "fen") 
+    // position (classic | modern | fen <7 or 8 fields>) [moves <move> ...]
+    auto mode = nextToken(args);
+    auto setup = mode;
+
+    if (mode == "fen")
     {
-        int numTokens = 7;
-        if (extras.size() < numTokens)
-            throw std::invalid_argument(
-                "FEN requires " + std::to_string(numTokens) + " parameters, but received " + std::to_string(extras.size()));
+        constexpr int FIELDS = 7;
+
+        std::string_view first = nextToken(args), last = first;
+        for (int i = 1; i < FIELDS && !last.empty(); ++i)
+            last = nextToken(args);
 
-        fen = concatenate(extras, 0, numTokens, ' ');
-        extras.erase(extras.begin(), extras.begin() + numTokens);
+        if (last.empty())
+            throw std::invalid_argument("FEN requires " + std::to_string(FIELDS) + " fields");
+
+        // The alive players field is optional
+        auto rest = args;
+        if (auto alive = nextToken(rest); !alive.empty() && alive != "moves")
+            last = alive, args = rest;
+
+        setup = std::string_view(mode.data(), last.data() + last.size() - mode.data());
     }
-    else if (position_mode == "modern" ) fen = FEN_MODERN ;
-    else if (position_mode == "classic") fen = FEN_CLASSIC;
-    
-    fromString(fen, pos);
+    else if (mode != "modern" && mode != "classic")
+        throw std::invalid_argument("expected classic, modern or fen");
+
+    auto keyword = nextToken(args);
+    if (!keyword.empty() && keyword != "moves")
+        throw std::invalid_argument("expected 'moves' keyword");
+
+    auto moves = trim(args);
+
+    // A GUI resends the whole game every turn: when it extends the game we
+    // already hold, only the new moves are played
+    auto known = position_moves.size();
+    bool extends = setup == position_setup && moves.starts_with(position_moves)
+                && (known == 0 || known == moves.size() || moves[known] == ' ');
 
-    if (extras.empty()) return;
+    // Forget the game until this command has fully succeeded
+    position_setup.clear();
 
-    if (extras[0] == "moves")
+    if (extends) moves.remove_prefix(known);
+    else
     {
-        Move moves[MAX_MOVES];
-        int size = 0;
+             if (mode == "modern" ) fromString(FEN_MODERN , pos);
+        else if (mode == "classic") fromString(FEN_CLASSIC, pos);
+        else fromString(setup.substr(mode.size()), pos);
+    }
+
+    Move list[MAX_MOVES];
 
-        extras.erase(extras.begin());
-        for (const auto& move : extras)
+    // Legal moves of the player to move, knocking out every player who has
+    // none (checkmated or stalemated) until someone can move
+    auto generate = [&]()
+    {
+        while (true)
         {
-            size = 0;
-            size += genAllNoisyMoves(pos, moves + size);
-            size += genAllQuietMoves(pos, moves + size);
-
-            for (int i = 0; i < size; ++i)
-            {
-                if (toString(moves[i]) == move)
-                {
-                    pos.makemove(moves[i]);
-                    break;
-                }                
-            }      
+            int size = 0;
+            size += genAllNoisyMoves(pos, list + size);
+            size += genAllQuietMoves(pos, list + size);
+            size = static_cast<int>(std::remove_if(list, list + size, [&](Move m) { return !isLegal(pos, m); }) - list);
+
+            if (size > 0 || std::popcount(pos.states.back().alive) == 1)
+                return size;
+
+            pos.eliminate();
         }
-    } 
-    else { throw std::invalid_argument("expected 'moves' keyword"); }
+    };
+
+    for (auto token = nextToken(moves); !token.empty(); token = nextToken(moves))
+    {
+        // The state stack holds the game and the search on top of it
+        if (pos.states.size() > MAX_PLY - 128)
+            throw std::invalid_argument("too many moves");
+
+        Square source, target;
+        Piece evolve;
+        fromString(token, source, target, evolve);
+
+        int size = generate();
+
+        auto match = [&](Move move) {
+            return move.source() == source && move.target() == target
+                && (move.nature() == Evolve ? move.evolve().piece() : Empty) == evolve;
+        };
+
+        auto found = std::find_if(list, list + size, match);
+        if (found == list + size)
+            throw std::invalid_argument("invalid move: " + std::string(token));
+
+        pos.makemove(*found);
+    }
+
+    generate();
+
+    position_setup = setup;
+    position_moves = trim(args);
 }
 
-void Engine::handleGo()
+// Steady clock nanoseconds `ms` from now, the deadline SearchControl takes
+static std::int64_t deadlineIn(int ms)
 {
-    int depth = 3;
+    return (std::chrono::steady_clock::now() + std::chrono::milliseconds(ms)).time_since_epoch().count();
+}
+
+void Engine::handleGo(std::string_view args)
+{
+    // go [depth N] [movetime MS] [wtime MS] [btime MS] [winc MS] [binc MS]
+    // [movestogo N] [infinite] [ponder]. wtime and winc are Red and Yellow's
+    // clock, btime and binc Blue and Green's. Without a limit the search stops
+    // at depth 3, infinite and ponder searches until told.
+    int depth = 0;
+    int movetime = 0;
+    int movestogo = 0;
+    ndarray<int, 2> time{}, inc{};
+    bool infinite = false;
+    bool ponder = false;
+
+    for (auto token = nextToken(args); !token.empty(); token = nextToken(args))
+    {
+             if (token == "depth"    ) fromString(nextToken(args), depth);
+        else if (token == "movetime" ) fromString(nextToken(args), movetime);
+        else if (token == "wtime"    ) fromString(nextToken(args), time[RY]);
+        else if (token == "btime"    ) fromString(nextToken(args), time[BG]);
+        else if (token == "winc"     ) fromString(nextToken(args), inc[RY]);
+        else if (token == "binc"     ) fromString(nextToken(args), inc[BG]);
+        else if (token == "movestogo") fromString(nextToken(args), movestogo);
+        else if (token == "infinite" ) infinite = true;
+        else if (token == "ponder"   ) ponder = true;
+    }
+
+    if (depth < 0 || depth > MAX_PV || movetime < 0 || movestogo < 0
+        || std::ranges::min(time) < 0 || std::ranges::min(inc) < 0)
+        throw std::invalid_argument("invalid go limits");
 
-    auto* goCommand = app.get_subcommand("go");
-    const auto& extras = goCommand ? goCommand->remaining()
-                                   : std::vector<std::string>{};
+    *search_pos = pos;
 
-    // Parse optional "go depth N" from UCI input; default to depth 3 on error.
-    for (size_t i = 0; i + 1 < extras.size(); ++i)
+    // Play the replies the last search expects from the other players, so
+    // the ponder search starts on this engine's next turn
+    if (ponder)
     {
-        if (extras[i] == "depth")
+        for (const auto& [hash, move] : expected)
         {
-            try {
-                depth = std::stoi(extras[i + 1]);
-            } catch (...) {
-                depth = 3;
-            }
-            break;
+            const GameState& gs = search_pos->states.back();
+            if (gs.turn == expected_turn) break;
+            if (gs.hash == hash) search_pos->makemove(move);
         }
     }
 
-    using namespace std::chrono;
+    // Without the whole expected line there is no position of ours to think
+    // about. The search then waits for ponderhit, which makes the position
+    // given with go the real one.
+    const bool wait = ponder && search_pos->states.back().turn != expected_turn;
+    if (wait) *search_pos = pos;
+
+    // A clock is split over the moves still to play, never more than half of it
+    const Guild us = toGuild(search_pos->states.back().turn);
+    if (movetime == 0 && time[us] > 0)
+    {
+        const int togo = movestogo > 0 ? movestogo : MOVES_TO_GO;
+        movetime = std::clamp(time[us] / togo + inc[us], 1, std::max(time[us] / 2, 1));
+    }
+
+    // The budget once a ponder search turns real
+    go_depth = depth > 0 ? depth : movetime > 0 ? MAX_PV : DEFAULT_DEPTH;
+    go_movetime = movetime;
+
+    if (wait)
+    {
+        std::lock_guard lock(search_mutex);
+        pondering = deferred = true;
+        analysing = infinite;
+        held.clear();
+        return;
+    }
+
+    control.depth = ponder || infinite ? (depth > 0 ? depth : MAX_PV) : go_depth;
+    control.deadline = ponder || movetime == 0 ? 0 : deadlineIn(movetime);
 
-    // Start timing the search.
-    auto start = steady_clock::now();
+    {
+        std::lock_guard lock(search_mutex);
+        pondering = ponder;
+        analysing = infinite;
+        held.clear();
+    }
 
-    // Fresh Thread: holds root move / score and node counter.
+    startSearch();
+}
+
+void Engine::startSearch()
+{
+    control.stop = false;
+    control.completed = 0;
+    control.multipv = multipv;
+    searcher = std::thread([this]() { runSearch(); });
+}
+
+void Engine::runSearch()
+{
     Thread thread{};
-    thread.score = 0;
-    thread.move  = Move{};
-    thread.nodes = 0;
-
-    // Core search: full window [-SCORE_INFINITY, +SCORE_INFINITY]
-    int score = negamax(pos, thread, -SCORE_INFINITY, SCORE_INFINITY, depth, 0);
-
-    // Stop timing.
-    auto end = steady_clock::now();
-    auto ms  = duration_cast<milliseconds>(end - start).count();
-
-    // Nodes and nodes-per-second (nps) from the Thread.
-    std::uint64_t nodes = thread.nodes;
-    std::uint64_t nps   = 0;
-    if (ms > 0) {
-        double seconds = ms / 1000.0;
-        nps = static_cast<std::uint64_t>(nodes / seconds);
-    }
-
-    // UCI info: depth, score (cp), nodes, time (ms), nps, best move.
-    std::cout << "info depth " << depth
-              << " score cp " << score
-              << " nodes " << nodes
-              << " time " << ms
-              << " nps " << nps
-              << " pv " << toString(thread.move)
-              << std::endl;
-              
-    std::cout << "bestmove " << toString(thread.move) << std::endl << std::flush;
+    thread.nnue = &nnue;
+    nnue.reset();
+
+    if (!trace_file.empty())
+    {
+        tracer.start(trace_file, toString(*search_pos), 1, trace_sample, trace_depth);
+        thread.trace = tracer.ring(0);
+    }
+
+    search(*search_pos, thread, control, std::cout);
+
+    if (thread.trace)
+    {
+        auto dropped = tracer.stop();
+        if (dropped > 0)
+            std::cout << "info string trace dropped " << dropped << " records, raise TraceSample" << std::endl;
+    }
+
+    // Hybrid evaluation: how often material alone answered without the network
+    if (nnue.loaded() && thread.evals > 0) {
+        std::cout << "info string nnue evals " << thread.evals
+                  << " skipped " << thread.skips
+                  << " (" << (100 * thread.skips / thread.evals) << "%)"
+                  << std::endl;
+    }
+
+#if ATHENA_STATS
+    thread.stats.report(std::cout);
+#endif
+
+    // Remember the line with the position before each move, the next
+    // go ponder follows it through the other players' turns
+    expected.clear();
+    expected_turn = search_pos->states.back().turn;
+    for (Move m : thread.pv)
+    {
+        expected.emplace_back(search_pos->states.back().hash, m);
+        search_pos->makemove(m);
+    }
+
+    std::string line = "bestmove " + toString(thread.move);
+    if (thread.pv.size() > 1)
+        line += " ponder " + toString(thread.pv[1]);
 
+    // Ponder and infinite searches hold their bestmove until ponderhit or stop
+    std::lock_guard lock(search_mutex);
+    if (pondering || analysing) held = line;
+    else std::cout << line << std::endl << std::flush;
 }
 
-void Engine::handleStop()
+void Engine::handlePonderHit(std::string_view)
 {
-    // currently a stub
+    std::lock_guard lock(search_mutex);
+    if (!pondering) return;
+    pondering = false;
+
+    // A ponder that never started searches the now real position from scratch
+    if (deferred)
+    {
+        deferred = false;
+        control.depth = go_depth;
+        control.deadline = go_movetime > 0 ? deadlineIn(go_movetime) : 0;
+        startSearch();
+        return;
+    }
+
+    // The expected line was played, the search now runs on the real budget
+    if (!held.empty() && !analysing)
+    {
+        std::cout << held << std::endl << std::flush;
+        held.clear();
+        return;
+    }
+
+    control.depth = go_depth;
+    if (go_movetime > 0)
+        control.deadline = deadlineIn(go_movetime);
+    if (control.completed >= go_depth)
+        control.stop = true;
 }
 
-void Engine::handleQuit()
+void Engine::handleStop(std::string_view)
 {
-    std::exit(0);
+    control.stop = true;
+
+    bool waiting;
+    {
+        std::lock_guard lock(search_mutex);
+        waiting = std::exchange(deferred, false);
+        pondering = analysing = false;
+        if (!held.empty())
+        {
+            std::cout << held << std::endl << std::flush;
+            held.clear();
+        }
+    }
+
+    // A ponder that never started still owes a bestmove. With stop already
+    // set the search finishes its first iteration and nothing more.
+    if (waiting)
+    {
+        control.completed = 0;
+        control.depth = 1;
+        control.deadline = 0;
+        runSearch();
+    }
+
+    if (searcher.joinable()) searcher.join();
+}
+
+void Engine::finish()
+{
+    bool open;
+    {
+        std::lock_guard lock(search_mutex);
+        open = pondering || analysing;
+    }
+
+    if (open) handleStop({});
+    else if (searcher.joinable()) searcher.join();
+}
+
+void Engine::handleQuit(std::string_view)
+{
+    std::exit(status);
 }
 
 void Engine::handlePerft()
 {
-    runPerftTests(pos, perft_depth, perft_full, perft_split, perft_cumulative);
+    if (!perft_against.empty())
+    {
+        std::ifstream trace(perft_against);
+        if (!trace)
+            throw std::invalid_argument("cannot open trace file: " + perft_against);
+
+        std::unique_ptr<PerftTable> table;
+        if (perft_hash > 0) table = std::make_unique<PerftTable>(perft_hash, false);
+
+        if (divideAgainst(pos, perft_depth, trace, std::cout, perft_threads, table.get()))
+            status = 1;
+        return;
+    }
+
+    if (perft_copy)
+        runPerftTests<CopyMake>(pos, perft_depth, perft_full, perft_split, perft_cumulative, perft_threads, perft_hash);
+    else
+        runPerftTests(pos, perft_depth, perft_full, perft_split, perft_cumulative, perft_threads, perft_hash);
+}
+
+void Engine::handlePerftSuite()
+{
+    std::ifstream input(suite_input);
+    if (!input)
+        throw std::invalid_argument("cannot open input file: " + suite_input);
+
+    std::ofstream file;
+    if (!suite_output.empty())
+    {
+        file.open(suite_output);
+        if (!file)
+            throw std::invalid_argument("cannot open output file: " + suite_output);
+    }
+
+    int failed = runPerftSuite(input, file.is_open() ? file : std::cout, suite_threads, suite_csv);
+    if (failed > 0) status = 1;
+
+    if (file.is_open())
+        std::cout << "info string perft-suite " << (failed ? "failed " + std::to_string(failed) + " counts" : "passed") << std::endl;
+}
+
+void Engine::handleBench()
+{
+    runBench(std::cout, bench_depth, bench_threads);
+}
+
+void Engine::handleScore()
+{
+    if (!nnue.loaded())
+        throw std::invalid_argument("no network loaded, set EvalFile first");
+
+    std::ifstream input(score_input);
+    if (!input)
+        throw std::invalid_argument("cannot open input file: " + score_input);
+
+    std::ofstream file;
+    if (!score_output.empty())
+    {
+        file.open(score_output);
+        if (!file)
+            throw std::invalid_argument("cannot open output file: " + score_output);
+    }
+    std::ostream& output = score_output.empty() ? std::cout : file;
+
+    // Positions are parsed into a reusable chunk and scored a chunk at a time
+    constexpr std::size_t chunk = 4 * BatchSize;
+    std::vector<Position> positions(chunk);
+    std::vector<int32_t> scores(chunk);
+
+    std::uint64_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    std::string line;
+    std::size_t size = 0;
+    bool done = false;
+    while (!done)
+    {
+        done = !std::getline(input, line);
+        if (!done && !line.empty())
+            fromString(line, positions[size++]);
+
+        if (size == chunk || (done && size > 0))
+        {
+            nnue.evaluate(positions.data(), size, scores.data());
+            for (std::size_t i = 0; i < size; ++i)
+                output << scores[i] << '\n';
+            total += size;
+            size = 0;
+        }
+    }
+    output << std::flush;
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "info string scored " << total << " positions in "
+              << std::fixed << std::setprecision(3) << seconds << " s ("
+              << static_cast<std::uint64_t>(seconds > 0 ? total / seconds : 0) << " pos/s)" << std::endl;
 }
 
 void Engine::handlePrint()
@@ -4,67 +4,70 @@
 #include "chess.h"
 #include "movegen.h"
 #include "utility.h"
+#include "nnue/nnue.h"
 #include <array>
 
 namespace athena {
 
-static inline int count_legal_moves_for(Position const& pos, Color who) {
-    Position tmp = pos;                       // cheap copy for turn tweak
-    tmp.states.back().turn = who;             // set side to move
+// Moves `who` would have on move. Only the turn is swapped, in place and
+// back again, rather than copying the whole Position for each color.
+static inline int count_legal_moves_for(Position& pos, Color who) {
+    Color& turn = pos.states.back().turn;
+    const Color saved = turn;
+    turn = who;
     Move moves[MAX_MOVES];
     int sz = 0;
-    sz += genAllNoisyMoves(tmp, moves + sz);
-    sz += genAllQuietMoves(tmp, moves + sz);
+    sz += genAllNoisyMoves(pos, moves + sz);
+    sz += genAllQuietMoves(pos, moves + sz);
+    turn = saved;
     return sz;
 }
 
-int evaluate(const Position& pos) {
-    // ---- material ----
-    std::array<int, COLOR_NB> material{};
+int NNUE_THRESHOLD = 1000;
 
-    for (Square sq : ALL_SQUARES) {
-        const auto pc = pos.board[sq];
-        const Color c  = pc.color();
-        if (c == None) continue;  // empty/invalid
+int material(const Position& pos) {
+    const GameState& gs = pos.states.back();
 
-        const auto pt = pc.piece();
-        int val = 0;
-        switch (pt) {
-            case Pawn:   val = 100; break;
-            case Knight: val = 300; break;
-            case Bishop: val = 300; break;
-            case Rook:   val = 500; break;
-            case Queen:  val = 900; break;
-            // no king/empty/stone in material
-            case King:
-            case Empty:
-            case Stone:
-            default:     val = 0;   break;
-        }
-        material[c] += val;
+    int score = 0;
+    for (Color c : COLORS) {
+        if (!(gs.alive & aliveBit(c))) continue;
+        score += toGuild(c) == toGuild(gs.turn) ? pos.board.value(c) : -pos.board.value(c);
     }
+    return score;
+}
 
-    const Color stm = pos.states.back().turn;
-
-    int total = 0;
-    for (int m : material) total += m;
-
-    const int stmMat    = material[stm];
-    const int othersMat = total - stmMat;
+int evaluate(Position& pos) {
+    const GameState& gs = pos.states.back();
 
     // ---- mobility (lightweight) ----
     constexpr int mobilityWeight = 1;  // keep tiny; material should dominate
-    const int myMoves = count_legal_moves_for(pos, stm);
-
-    int oppMoves = 0;
-    for (int c = 0; c < COLOR_NB; ++c) {
-        if (static_cast<Color>(c) == stm) continue;
-        oppMoves += count_legal_moves_for(pos, static_cast<Color>(c));
+    int mobility = 0;
+    for (Color c : COLORS) {
+        if (!(gs.alive & aliveBit(c))) continue;
+        const int moves = count_legal_moves_for(pos, c);
+        mobility += toGuild(c) == toGuild(gs.turn) ? moves : -moves;
     }
+    mobility *= mobilityWeight;
 
-    const int mobility = mobilityWeight * (myMoves - oppMoves);
+    // ---- material (kept incrementally by Board) ----
+    return material(pos) + mobility;
+}
+
+int evaluate(Position& pos, Thread& thread, int alpha, int beta) {
+    if (thread.nnue == nullptr || !thread.nnue->loaded())
+        return evaluate(pos);
+
+    thread.evals++;
+
+    // Lopsided material (e.g. a player knocked out) decides the node, the
+    // classical score stands in for the network there
+    const int score = material(pos);
+    if (score - NNUE_THRESHOLD >= beta || score + NNUE_THRESHOLD <= alpha) {
+        thread.skips++;
+        return evaluate(pos);
+    }
 
-    return (stmMat - othersMat) + mobility;
+    return thread.nnue->evaluate(pos);
 }
 
 } // namespace athena
@@ -3,10 +3,10 @@
 namespace athena
 {
 
-bool isSquareAttacked(const Position& pos, Square source, Color color) noexcept
+// Attack test against an arbitrary occupancy: `occupied` blocks sliders and
+// only pieces in `enemy` attack, so callers can test a move without making it
+inline bool isSquareAttacked(const Position& pos, Square source, Color color, BitBoard occupied, BitBoard enemy) noexcept
 {
-    auto enemy = pos.board.opponent(color);
-
     if (enemy & pos.board.occ(Knight) & PIECE_ATTACK[Knight][source])
         return true;
 
@@ -17,15 +17,15 @@ bool isSquareAttacked(const Position& pos, Square source, Color color) noexcept
     rBB = (enemy & rBB & PIECE_ATTACK[Rook][source]);
 
     for (auto target: bBB)
-        if (!(between(source, target, Bishop) & pos.board.everyone()))
+        if (!(between(source, target, Bishop) & occupied))
             return true;
 
     for (auto target: rBB)
-        if (!(between(source, target, Rook) & pos.board.everyone()))
+        if (!(between(source, target, Rook) & occupied))
             return true;
 
     for (auto opp: OPPONENTS[color])
-        if (pos.board.occ(Pawn, opp) & COLOR_ATTACK[ally(opp)][source])
+        if (enemy & pos.board.occ(Pawn, opp) & COLOR_ATTACK[ally(opp)][source])
             return true;
 
     if (enemy & pos.board.occ(King) & PIECE_ATTACK[King][source])
@@ -34,10 +34,69 @@ bool isSquareAttacked(const Position& pos, Square source, Color color) noexcept
     return false;
 }
 
+bool isSquareAttacked(const Position& pos, Square source, Color color) noexcept
+{
+    return isSquareAttacked(pos, source, color, pos.board.everyone(), pos.board.opponent(color, pos.states.back().alive));
+}
+
 bool isRoyalSafe(const Position& pos, Color color) noexcept {
     return !isSquareAttacked(pos, pos.board.royal(color), color);
 }
 
+BitBoard pinnedPieces(const Position& pos, Color color) noexcept
+{
+    auto royal = pos.board.royal(color);
+    auto enemy = pos.board.opponent(color, pos.states.back().alive);
+
+    auto bBB = enemy & pos.board.occ(Bishop, Queen) & PIECE_ATTACK[Bishop][royal];
+    auto rBB = enemy & pos.board.occ(Rook,   Queen) & PIECE_ATTACK[Rook][royal];
+
+    BitBoard pinned;
+
+    for (auto sq: bBB)
+    {
+        auto blockers = between(royal, sq, Bishop) & pos.board.everyone();
+        if (blockers.popCount() == 1 && (blockers & pos.board.occ(color)))
+            pinned |= blockers;
+    }
+
+    for (auto sq: rBB)
+    {
+        auto blockers = between(royal, sq, Rook) & pos.board.everyone();
+        if (blockers.popCount() == 1 && (blockers & pos.board.occ(color)))
+            pinned |= blockers;
+    }
+
+    return pinned;
+}
+
+bool isLegal(const Position& pos, Move move) noexcept
+{
+    const GameState& gs = pos.states.back();
+
+    auto source = move.source();
+    auto target = move.target();
+
+    BitBoard from, to, gone;
+    from.setSQ(source);
+    to.setSQ(target);
+
+    if (move.nature() == Enpass)
+        gone.setSQ(target + PUSH_DELTA[move.enpass()]);
+
+    if (move.nature() == Castle)
+    {
+        from.setSQ(SOURCE_CASTLE[pos.setup][gs.turn][move.castle()]);
+        to.setSQ(TARGET_CASTLE[pos.setup][gs.turn][move.castle()]);
+    }
+
+    auto occupied = (pos.board.everyone() & ~from & ~gone) | to;
+    auto enemy = pos.board.opponent(gs.turn, gs.alive) & ~to & ~gone;
+
+    auto royal = pos.board[source].piece() == King ? target : pos.board.royal(gs.turn);
+    return !isSquareAttacked(pos, royal, gs.turn, occupied, enemy);
+}
+
 inline auto genJumperMoves(const Position& pos, Move* moves, auto jumpers, auto allowed, Piece piece, MoveFlag flag)
 {
     for (auto source: jumpers)
@@ -87,7 +146,7 @@ inline auto genTakeMoves(const Position& pos, Move* moves)
     auto sE = TAKE_DELTA[gs.turn][0];
     auto sW = TAKE_DELTA[gs.turn][1];
 
-    auto enemy = pos.board.opponent(gs.turn);
+    auto enemy = pos.board.opponent(gs.turn, gs.alive);
     auto pawns = pos.board.occ(Pawn, gs.turn) & ~PROMOTE[gs.turn];
     auto takeE = pawns.shift(sE) & enemy;
     auto takeW = pawns.shift(sW) & enemy;
@@ -112,7 +171,7 @@ inline auto genEvolveMoves(const Position& pos, Move* moves)
         auto dest = BB(); 
 
         auto empty = ~pos.board.everyone() & ~BRICK;
-        auto enemy =  pos.board.opponent(gs.turn);
+        auto enemy =  pos.board.opponent(gs.turn, gs.alive);
 
         auto pushS = static_cast<Square>(source + s1);
         auto takeE = static_cast<Square>(source + s2);
@@ -140,7 +199,9 @@ inline auto genEnpassMoves(const Position& pos, Move* moves)
     for (auto opp: OPPONENTS[gs.turn])
     {
         auto epsq  = gs.enpass[opp];
-        if (epsq != OFFBOARD) 
+
+        // The double-pushed pawn may have been taken since it was pushed
+        if (epsq != OFFBOARD && pos.board[epsq + PUSH_DELTA[opp]] == PieceClass(Pawn, opp)) 
         {
             auto pawns = pos.board.occ(Pawn, gs.turn) & COLOR_ATTACK[opp][epsq]; 
             for (auto source: pawns)
@@ -155,7 +216,7 @@ inline auto genCastleMoves(const Position& pos, Move* moves)
     const GameState& gs = pos.states.back();
     for (auto side: SIDES)
     {
-        if (!hasCastle(gs.castle, RIGHTS[pos.setup][gs.turn][side]))
+        if (!(gs.castle & castleBit(gs.turn, side)))
             continue;
 
         if (pos.board.everyone() & PASS[pos.setup][gs.turn][side])
@@ -178,7 +239,7 @@ inline auto genMoves(const Position& pos, Move* moves)
     const GameState& gs = pos.states.back();
 
     BitBoard allowed;
-    if constexpr (flag == Noisy) allowed =  pos.board.opponent(gs.turn);
+    if constexpr (flag == Noisy) allowed =  pos.board.opponent(gs.turn, gs.alive);
     if constexpr (flag == Quiet) allowed = ~pos.board.everyone() & ~BRICK;
 
     auto own = pos.board.occ(gs.turn);
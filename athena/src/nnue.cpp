@@ -0,0 +1,51 @@
+#include "nnue/nnue.h"
+#include <fstream>
+#include <utility>
+
+namespace athena
+{
+
+namespace {
+
+// Builds the model whose Id matches, or returns nullptr for unknown ids
+template <std::size_t... I>
+std::unique_ptr<ModelBase> makeModel(uint32_t id, std::index_sequence<I...>)
+{
+    std::unique_ptr<ModelBase> model;
+    ((id == std::tuple_element_t<I, Architectures>::Id
+          ? (model = std::make_unique<Model<std::tuple_element_t<I, Architectures>>>(), true)
+          : false) || ...);
+    return model;
+}
+
+} // namespace
+
+NNUE::NNUE() : model(std::make_unique<Model<DefaultArch>>()) {}
+
+bool NNUE::load(const std::string& path)
+{
+    loaded_ = false;
+
+    std::ifstream file(path, std::ios::binary);
+
+    uint32_t magic = 0, version = 0, id = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&id), sizeof(id));
+    if (!file || magic != NetworkMagic || version != NetworkVersion)
+        return false;
+
+    auto next = makeModel(id, std::make_index_sequence<std::tuple_size_v<Architectures>>());
+    if (!next || !next->read(file))
+        return false;
+
+    // Trailing data means the file was written for a different architecture
+    if (file.peek() != std::ifstream::traits_type::eof())
+        return false;
+
+    model = std::move(next);
+    loaded_ = true;
+    return true;
+}
+
+} // namespace athena
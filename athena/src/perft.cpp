@@ -1,9 +1,17 @@
 #include "perft.h"
 #include "movegen.h"
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <map>
+#include <set>
+#include <stdexcept>
 #include "utility.h"
 
 namespace athena
@@ -20,62 +28,156 @@ std::string formatInt(uint64_t num)
     return numStr;
 }
 
-void perft(Position& pos, Record& rc, int depth, bool full = false)
+void count(Record& rc, Move move)
 {
-    const GameState& gs = pos.states.back();
+    switch (move.flag())
+    {
+        case Noisy: rc.noisy++; break;
+        case Quiet: rc.quiet++; break;
+    }
 
-    if (depth == 0)
+    switch (move.nature())
     {
-        rc.nodes++;
+        case Jumper: rc.jumper++; break;
+        case Slider: rc.slider++; break;
+        case Pushed: rc.pushed++; break;
+        case Stride: rc.stride++; break;
+        case Strike: rc.strike++; break;
+        case Evolve: rc.evolve++; break;
+        case Enpass: rc.enpass++; break;
+        case Castle: rc.castle++; break;
+    }
+}
+
+PerftTable::PerftTable(std::size_t megabytes, bool full) : full(full)
+{
+    std::size_t bytes = megabytes << 20;
+    std::size_t entry = full ? sizeof(RecordEntry) : sizeof(NodeEntry);
+
+    std::size_t size = 1;
+    while (size * 2 * entry <= bytes) size *= 2;
+    mask = size - 1;
+
+    if (full) records = std::make_unique<RecordEntry[]>(size);
+    else      nodes   = std::make_unique<NodeEntry[]>(size);
+}
+
+std::size_t PerftTable::index(uint64_t key, int depth) const
+{
+    return (key ^ (depth * 0x9E3779B97F4A7C15ULL)) & mask;
+}
+
+bool PerftTable::probe(uint64_t key, int depth, Record& rc)
+{
+    if (full)
+    {
+        RecordEntry& e = records[index(key, depth)];
+        if (e.lock.test_and_set(std::memory_order_acquire)) return false;
+
+        bool hit = e.key == key && e.depth == depth;
+        if (hit) rc = e.rc;
+
+        e.lock.clear(std::memory_order_release);
+        return hit;
+    }
+
+    const NodeEntry& e = nodes[index(key, depth)];
+    uint64_t data  = e.data.load(std::memory_order_relaxed);
+    uint64_t check = e.check.load(std::memory_order_relaxed);
+
+    // A torn entry fails the check and reads as a miss
+    if ((check ^ data) != key || (data & 0xFF) != static_cast<uint64_t>(depth))
+        return false;
+
+    rc = Record();
+    rc.nodes = data >> 8;
+    return true;
+}
+
+void PerftTable::store(uint64_t key, int depth, const Record& rc)
+{
+    if (full)
+    {
+        RecordEntry& e = records[index(key, depth)];
+        if (e.lock.test_and_set(std::memory_order_acquire)) return;
+
+        e.key = key;
+        e.depth = depth;
+        e.rc = rc;
+
+        e.lock.clear(std::memory_order_release);
         return;
     }
 
+    NodeEntry& e = nodes[index(key, depth)];
+    uint64_t data = (rc.nodes << 8) | static_cast<uint64_t>(depth);
+    e.data.store(data, std::memory_order_relaxed);
+    e.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+template <typename Policy>
+void perft(Position& pos, Policy& walk, Record& rc, int depth, bool full, PerftTable* table);
+
+// Last ply: legal moves are counted without touching the board. Unless the
+// king is in check, a move by a piece that is not pinned, not the king and
+// not taking en passant cannot expose the king, so only the rest are tested.
+bool countLeaves(Position& pos, Record& rc, bool full)
+{
+    const GameState& gs = pos.states.back();
+
     Move moves[MAX_MOVES];
     int size = 0; 
     size += genAllNoisyMoves(pos, moves + size);
     size += genAllQuietMoves(pos, moves + size);
 
-    bool noLegalMove = true;
+    auto royal = pos.board.royal(gs.turn);
+    bool check = isSquareAttacked(pos, royal, gs.turn);
+    auto risky = pinnedPieces(pos, gs.turn);
+    risky.setSQ(royal);
+
+    uint64_t legal = 0;
     for (int i = 0; i < size; ++i)
     {
-        pos.makemove(moves[i]);
+        bool safe = !check && !risky.checkSQ(moves[i].source()) && moves[i].nature() != Enpass;
+        if (safe || isLegal(pos, moves[i]))
+        {
+            legal++;
+            if (full) count(rc, moves[i]);
+        }
+    }
+
+    rc.nodes += legal;
+    return legal > 0;
+}
+
+template <typename Policy>
+void expand(Position& pos, Policy& walk, Record& rc, int depth, bool full, PerftTable* table)
+{
+    const GameState& gs = pos.states.back();
+
+    bool noLegalMove = true;
+
+    if (depth == 1) noLegalMove = !countLeaves(pos, rc, full);
 
-        if (isRoyalSafe(pos, gs.turn))
+    else
+    {
+        Move moves[MAX_MOVES];
+        int size = 0; 
+        size += genAllNoisyMoves(pos, moves + size);
+        size += genAllQuietMoves(pos, moves + size);
+
+        for (int i = 0; i < size; ++i)
         {
-            noLegalMove = false;
+            walk.make(pos, moves[i]);
 
-            if (depth == 1)
+            if (isRoyalSafe(pos, gs.turn))
             {
-                rc.nodes++;           
-                
-                if (full)
-                {
-                    auto flag = moves[i].flag();
-                    switch (flag)
-                    {
-                        case Noisy: rc.noisy++; break;
-                        case Quiet: rc.quiet++; break;
-                    }
-
-                    auto nature = moves[i].nature();
-                    switch (nature)
-                    {
-                        case Jumper: rc.jumper++; break;
-                        case Slider: rc.slider++; break;
-                        case Pushed: rc.pushed++; break;
-                        case Stride: rc.stride++; break;
-                        case Strike: rc.strike++; break;
-                        case Evolve: rc.evolve++; break;
-                        case Enpass: rc.enpass++; break;
-                        case Castle: rc.castle++; break;
-                    }
-                }   
+                noLegalMove = false;
+                perft(pos, walk, rc, depth - 1, full, table);
             }
 
-            else perft(pos, rc, depth - 1, full);
+            walk.undo(pos, moves[i]);
         }
-
-        pos.undomove(moves[i]);
     }
 
     if (full && noLegalMove)
@@ -86,47 +188,203 @@ void perft(Position& pos, Record& rc, int depth, bool full = false)
     }
 }
 
-void runPerftTests(Position& pos, int depth, bool full, bool split, bool cumulative)
+template <typename Policy>
+void perft(Position& pos, Policy& walk, Record& rc, int depth, bool full, PerftTable* table)
 {
-    std::cout << std::endl;
+    if (depth == 0)
+    {
+        rc.nodes++;
+        return;
+    }
 
-    if (split)
+    // Even depth 1 is worth a probe: counting it means a legality check per move
+    if (table)
     {
-        Move moves[MAX_MOVES];
-        int size = 0;
-        size += genAllNoisyMoves(pos, moves + size);
-        size += genAllQuietMoves(pos, moves + size);
+        uint64_t key = pos.states.back().hash;
 
-        uint64_t totalNodes = 0;
-        double totalTime = 0.0;
+        Record sub;
+        if (!table->probe(key, depth, sub))
+        {
+            expand(pos, walk, sub, depth, full, table);
+            table->store(key, depth, sub);
+        }
 
-        for (int i = 0; i < size; ++i)
+        rc += sub;
+        return;
+    }
+
+    expand(pos, walk, rc, depth, full, table);
+}
+
+// Legal moves of the side to move
+int legalMoves(Position& pos, Move* legal)
+{
+    const GameState& gs = pos.states.back();
+
+    Move moves[MAX_MOVES];
+    int size = 0;
+    size += genAllNoisyMoves(pos, moves + size);
+    size += genAllQuietMoves(pos, moves + size);
+
+    int count = 0;
+    for (int i = 0; i < size; ++i)
+    {
+        pos.makemove(moves[i]);
+        if (isRoyalSafe(pos, gs.turn)) legal[count++] = moves[i];
+        pos.undomove(moves[i]);
+    }
+    return count;
+}
+
+// A subtree below the root: one root move, optionally followed by a reply
+struct PerftTask
+{
+    int  root;
+    int  length;
+    Move moves[2];
+};
+
+// Every ply pushes a GameState, the stack has no room past MAX_PLY
+void checkDepth(const Position& pos, int depth)
+{
+    if (depth < 0 || static_cast<std::size_t>(depth) > MAX_PLY - pos.states.size())
+        throw std::invalid_argument("perft depth " + std::to_string(depth) + " exceeds the state stack");
+}
+
+template <typename Policy>
+std::vector<std::pair<Move, Record>> divide(Position& pos, int depth, bool full, int threads, PerftTable* table)
+{
+    checkDepth(pos, depth);
+
+    Move roots[MAX_MOVES];
+    int size = legalMoves(pos, roots);
+
+    std::vector<std::pair<Move, Record>> result(size);
+    for (int i = 0; i < size; ++i) result[i].first = roots[i];
+
+    // Split at ply 2 when the tree is deep enough, so a few heavy root moves
+    // cannot leave threads idle. Nodes with no legal reply are settled here.
+    std::vector<PerftTask> tasks;
+    int length = depth >= 3 ? 2 : 1;
+
+    for (int i = 0; i < size; ++i)
+    {
+        if (length == 1)
+        {
+            tasks.push_back({i, 1, {roots[i], Move()}});
+            continue;
+        }
+
+        pos.makemove(roots[i]);
+
+        Move replies[MAX_MOVES];
+        int count = legalMoves(pos, replies);
+        for (int j = 0; j < count; ++j)
+            tasks.push_back({i, 2, {roots[i], replies[j]}});
+
+        if (full && count == 0)
         {
-            pos.makemove(moves[i]);
+            Record& rc = result[i].second;
+            rc.nodes += 1;
+            if (isRoyalSafe(pos, pos.states.back().turn)) rc.stalemates += 1;
+            else                                          rc.checkmates += 1;
+        }
+
+        pos.undomove(roots[i]);
+    }
 
-            const GameState& gs = pos.states.back();
+    // Threads pull tasks off a shared counter, each on its own Position copy
+    std::vector<Record> records(tasks.size());
+    std::atomic<std::size_t> next{0};
 
-            if (!isRoyalSafe(pos, gs.turn))
+    auto worker = [&]()
+    {
+        Position local = pos;
+        Policy walk;
+        for (std::size_t t; (t = next.fetch_add(1, std::memory_order_relaxed)) < tasks.size(); )
+        {
+            const PerftTask& task = tasks[t];
+            Record& rc = records[t];
+
+            for (int k = 0; k < task.length; ++k)
+                walk.make(local, task.moves[k]);
+
+            if (depth == task.length)
             {
-                pos.undomove(moves[i]);
-                continue;
+                rc.nodes++;
+                if (full) count(rc, task.moves[task.length - 1]);
             }
+            else perft(local, walk, rc, depth - task.length, full, table);
 
-            Record rc;
+            for (int k = task.length - 1; k >= 0; --k)
+                walk.undo(local, task.moves[k]);
+        }
+    };
 
-            auto start = std::chrono::high_resolution_clock::now();
-            perft(pos, rc, depth - 1, false);
-            auto end = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
 
-            std::chrono::duration<double> elapsed = end - start;
-            double seconds = elapsed.count();
+    for (std::size_t t = 0; t < tasks.size(); ++t)
+        result[tasks[t].root].second += records[t];
 
-            std::cout << toString(moves[i]) << ": " << rc.nodes << std::endl;
+    return result;
+}
 
-            totalNodes += rc.nodes;
-            totalTime += seconds;
+template <typename Policy>
+Record perft(Position& pos, int depth, bool full, int threads, PerftTable* table)
+{
+    checkDepth(pos, depth);
+
+    Record rc;
+
+    if (threads <= 1)
+    {
+        Policy walk;
+        perft(pos, walk, rc, depth, full, table);
+        return rc;
+    }
+
+    auto moves = divide<Policy>(pos, depth, full, threads, table);
+    for (const auto& [move, record] : moves)
+        rc += record;
+
+    if (full && moves.empty())
+    {
+        rc.nodes += 1;
+        if (isRoyalSafe(pos, pos.states.back().turn)) rc.stalemates += 1;
+        else                                          rc.checkmates += 1;
+    }
+
+    return rc;
+}
 
-            pos.undomove(moves[i]);
+template <typename Policy>
+void runPerftTests(Position& pos, int depth, bool full, bool split, bool cumulative, int threads, std::size_t hash)
+{
+    checkDepth(pos, depth);
+
+    // One table for every depth, shallower runs seed the deeper ones
+    std::unique_ptr<PerftTable> table;
+    if (hash > 0) table = std::make_unique<PerftTable>(hash, full);
+
+    std::cout << std::endl;
+
+    if (split)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto moves = divide<Policy>(pos, depth, false, threads, table.get());
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<double> elapsed = end - start;
+        double totalTime = elapsed.count();
+
+        uint64_t totalNodes = 0;
+        for (const auto& [move, rc] : moves)
+        {
+            std::cout << toString(move) << ": " << rc.nodes << std::endl;
+            totalNodes += rc.nodes;
         }
 
         std::cout << "total: " << formatInt(totalNodes) << " nodes, "
@@ -170,10 +428,8 @@ void runPerftTests(Position& pos, int depth, bool full, bool split, bool cumulat
 
         for (int d = 1; d <= depth; ++d)
         {
-            Record rc;
-
             auto start = std::chrono::high_resolution_clock::now();
-            perft(pos, rc, d, full);
+            Record rc = perft<Policy>(pos, d, full, threads, table.get());
             auto end = std::chrono::high_resolution_clock::now();
 
             std::chrono::duration<double> elapsed = end - start;
@@ -251,4 +507,271 @@ void runPerftTests(Position& pos, int depth, bool full, bool split, bool cumulat
     std::cout << std::endl;
 }
 
+// One EPD-style line: "<fen> ;D1 <nodes> ;D2 <nodes> ..."
+struct SuiteEntry
+{
+    std::string fen;
+    std::vector<std::pair<int, uint64_t>> expected;
+};
+
+struct SuiteResult
+{
+    int depth;
+    uint64_t nodes, expected;
+    double seconds;
+};
+
+std::vector<SuiteEntry> readPerftSuite(std::istream& input)
+{
+    std::vector<SuiteEntry> entries;
+    std::string line;
+    Position scratch;
+
+    for (int number = 1; std::getline(input, line); ++number)
+    {
+        // Blank lines and '#' comments
+        auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        auto fields = tokenize(line, ';');
+
+        SuiteEntry entry;
+        auto fen = tokenize(fields[0]);
+        if (fen.size() != 7 && fen.size() != 8)
+            throw std::invalid_argument("perft suite line " + std::to_string(number) + ": bad position");
+        entry.fen = concatenate(fen, 0, fen.size(), ' ');
+
+        // Parsed here on the calling thread, a worker thread must not throw
+        try { fromString(entry.fen, scratch); }
+        catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("perft suite line " + std::to_string(number) + ": " + e.what());
+        }
+
+        for (std::size_t i = 1; i < fields.size(); ++i)
+        {
+            auto spec = tokenize(fields[i]);
+            if (spec.size() != 2 || spec[0].size() < 2 || (spec[0][0] != 'D' && spec[0][0] != 'd'))
+                throw std::invalid_argument("perft suite line " + std::to_string(number) + ": bad depth entry '" + fields[i] + "'");
+
+            try { entry.expected.emplace_back(std::stoi(spec[0].substr(1)), std::stoull(spec[1])); }
+            catch (const std::logic_error&) {
+                throw std::invalid_argument("perft suite line " + std::to_string(number) + ": bad depth entry '" + fields[i] + "'");
+            }
+
+            try { checkDepth(scratch, entry.expected.back().first); }
+            catch (const std::invalid_argument& e) {
+                throw std::invalid_argument("perft suite line " + std::to_string(number) + ": " + e.what());
+            }
+        }
+
+        entries.push_back(std::move(entry));
+    }
+
+    return entries;
+}
+
+int runPerftSuite(std::istream& input, std::ostream& output, int threads, bool csv)
+{
+    auto entries = readPerftSuite(input);
+    std::vector<std::vector<SuiteResult>> results(entries.size());
+
+    // Whole positions are handed out to threads, each runs its depths in order
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]()
+    {
+        for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < entries.size(); )
+        {
+            Position pos;
+            fromString(entries[i].fen, pos);
+
+            for (auto [depth, expected] : entries[i].expected)
+            {
+                auto start = std::chrono::high_resolution_clock::now();
+                Record rc = perft(pos, depth, false);
+                auto end = std::chrono::high_resolution_clock::now();
+
+                std::chrono::duration<double> elapsed = end - start;
+                results[i].push_back({depth, rc.nodes, expected, elapsed.count()});
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+
+    int failed = 0;
+    uint64_t totalNodes = 0;
+    double totalTime = 0.0;
+
+    auto nps = [](uint64_t nodes, double seconds) {
+        return seconds > 0 ? static_cast<uint64_t>(nodes / seconds) : 0;
+    };
+
+    output << std::fixed << std::setprecision(6);
+
+    if (csv) output << "position,depth,nodes,expected,time,nps,ok\n";
+    else     output << "{\n  \"positions\": [\n";
+
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        if (!csv)
+            output << "    {\"fen\": \"" << entries[i].fen << "\", \"results\": [";
+
+        for (std::size_t k = 0; k < results[i].size(); ++k)
+        {
+            const auto& r = results[i][k];
+            bool ok = r.nodes == r.expected;
+
+            failed += !ok;
+            totalNodes += r.nodes;
+            totalTime += r.seconds;
+
+            if (csv)
+                output << i + 1 << "," << r.depth << "," << r.nodes << "," << r.expected << ","
+                       << r.seconds << "," << nps(r.nodes, r.seconds) << "," << (ok ? "true" : "false") << "\n";
+            else
+                output << (k ? ", " : "") << "{\"depth\": " << r.depth << ", \"nodes\": " << r.nodes
+                       << ", \"expected\": " << r.expected << ", \"time\": " << r.seconds
+                       << ", \"nps\": " << nps(r.nodes, r.seconds) << ", \"ok\": " << (ok ? "true" : "false") << "}";
+        }
+
+        if (!csv)
+            output << "]}" << (i + 1 < entries.size() ? "," : "") << "\n";
+    }
+
+    if (!csv)
+        output << "  ],\n"
+               << "  \"nodes\": " << totalNodes << ",\n"
+               << "  \"time\": " << totalTime << ",\n"
+               << "  \"nps\": " << nps(totalNodes, totalTime) << ",\n"
+               << "  \"failed\": " << failed << "\n}\n";
+
+    return failed;
+}
+
+// Reference divide trace: "<move> [<move> ...]: <nodes>" per line, the moves
+// being the path from the root. Plain "perft -s" output is a root-only trace.
+std::map<std::string, uint64_t> readDivideTrace(std::istream& input)
+{
+    std::map<std::string, uint64_t> trace;
+    std::string line;
+
+    while (std::getline(input, line))
+    {
+        auto colon = line.find(':');
+        if (colon == std::string::npos || line.rfind("total", 0) == 0 || line.rfind("#", 0) == 0)
+            continue;
+
+        auto path = tokenize(line.substr(0, colon));
+        if (path.empty()) continue;
+
+        std::string key = concatenate(path, 0, path.size(), ' ');
+        std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+        try { trace[key] = std::stoull(line.substr(colon + 1)); }
+        catch (const std::logic_error&) {
+            throw std::invalid_argument("bad divide trace line: " + line);
+        }
+    }
+
+    return trace;
+}
+
+int divideAgainst(Position& pos, int depth, std::istream& input, std::ostream& output, int threads, PerftTable* table)
+{
+    checkDepth(pos, depth);
+
+    auto trace = readDivideTrace(input);
+    if (trace.empty())
+        throw std::invalid_argument("divide trace is empty");
+
+    std::vector<Move> line;
+    std::string prefix;
+    int result = 0;
+
+    for (int d = depth; d >= 1; --d)
+    {
+        std::map<std::string, std::pair<Move, uint64_t>> ours;
+        for (const auto& [move, rc] : divide(pos, d, false, threads, table))
+            ours[toString(move)] = {move, rc.nodes};
+
+        // Reference entries exactly one move below the current path
+        std::map<std::string, uint64_t> theirs;
+        for (auto it = trace.lower_bound(prefix); it != trace.end() && it->first.rfind(prefix, 0) == 0; ++it)
+        {
+            auto rest = it->first.substr(prefix.size());
+            if (!rest.empty() && rest.find(' ') == std::string::npos)
+                theirs[rest] = it->second;
+        }
+
+        std::set<std::string> moves;
+        for (const auto& [move, entry] : ours) moves.insert(move);
+        for (const auto& [move, nodes] : theirs) moves.insert(move);
+
+        // A move only one side has is a movegen bug at this very node,
+        // otherwise follow the first count that differs
+        std::string missing, differs;
+        for (const auto& move : moves)
+        {
+            bool a = ours.count(move), b = theirs.count(move);
+            if (a != b) { if (missing.empty()) missing = move; }
+            else if (ours[move].second != theirs[move] && differs.empty()) differs = move;
+        }
+
+        if (missing.empty() && differs.empty())
+        {
+            output << "divide matches at depth " << d << (prefix.empty() ? "" : " after " + prefix) << std::endl;
+            break;
+        }
+
+        result = 1;
+
+        output << "depth " << d << (prefix.empty() ? "" : " after " + prefix) << std::endl;
+        for (const auto& move : moves)
+        {
+            bool a = ours.count(move), b = theirs.count(move);
+            if (a && b && ours[move].second == theirs[move]) continue;
+
+            output << "  " << std::setw(8) << std::left << move << std::right
+                   << " ours " << std::setw(12) << (a ? std::to_string(ours[move].second) : "-")
+                   << " theirs " << std::setw(12) << (b ? std::to_string(theirs[move]) : "-") << std::endl;
+        }
+
+        // Descend while the trace has the divide one level further down
+        std::string next = prefix + differs;
+        bool deeper = missing.empty() && d > 1 && trace.lower_bound(next + " ") != trace.end()
+                      && trace.lower_bound(next + " ")->first.rfind(next + " ", 0) == 0;
+
+        if (!deeper)
+        {
+            output << "fen " << toString(pos) << std::endl;
+            output << "path " << (prefix.empty() ? "(root)" : prefix.substr(0, prefix.size() - 1)) << std::endl;
+            output << "move " << (missing.empty() ? differs : missing) << std::endl;
+            break;
+        }
+
+        Move move = ours[differs].first;
+        pos.makemove(move);
+        line.push_back(move);
+        prefix = next + " ";
+    }
+
+    for (auto it = line.rbegin(); it != line.rend(); ++it)
+        pos.undomove(*it);
+
+    return result;
+}
+
+template Record perft<MakeUnmake>(Position&, int, bool, int, PerftTable*);
+template Record perft<CopyMake>(Position&, int, bool, int, PerftTable*);
+
+template std::vector<std::pair<Move, Record>> divide<MakeUnmake>(Position&, int, bool, int, PerftTable*);
+template std::vector<std::pair<Move, Record>> divide<CopyMake>(Position&, int, bool, int, PerftTable*);
+
+template void runPerftTests<MakeUnmake>(Position&, int, bool, bool, bool, int, std::size_t);
+template void runPerftTests<CopyMake>(Position&, int, bool, bool, bool, int, std::size_t);
+
 } // namespace athena
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "position.h"
+#include "zobrist.h"
+#include <bit>
 
 namespace athena
 {
@@ -15,60 +17,111 @@ void Position::makemove(Move move)
     auto take = board[target];
     auto hash = gs.hash;
 
-    // Update clock
-    int clock = 0;
-    if (take.piece() != Empty && type.piece() != Pawn && nature != Castle)
-        clock = gs.clock + 1;
+    // Update clock, captures and pawn moves cannot be taken back
+    int clock = gs.clock + 1;
+    if (take != EMPTY || type.piece() == Pawn)
+        clock = 0;
 
     // Update castle
-    auto castle = gs.castle;
-    castle.popSQ(source);
-    castle.popSQ(target);
+    uint8_t castle = gs.castle & CASTLE_MASK[setup][source] & CASTLE_MASK[setup][target];
+    hash ^= ZOBRIST.castle[gs.castle] ^ ZOBRIST.castle[castle];
 
     // 
     auto enpass = gs.enpass;
+    hash ^= ZOBRIST.enpass[enpass[gs.turn]];
     enpass[gs.turn] = OFFBOARD;
+
+    // Record changed pieces, accumulators are updated lazily on evaluation
+    DirtyPiece dirty;
  
     if (nature == Stride)
     {
         board.popSQ(source);
         board.setSQ(target, type);
         enpass[gs.turn] = target - PUSH_DELTA[gs.turn];
+        hash ^= ZOBRIST.enpass[enpass[gs.turn]];
+        dirty.add(type, source, target);
     }
 
     else if (nature == Enpass)
     {
-        board.popSQ(target + PUSH_DELTA[move.enpass()]);
+        auto victim = target + PUSH_DELTA[move.enpass()];
+        if (board[victim] != EMPTY)
+        {
+            dirty.add(board[victim], victim, OFFBOARD);
+            board.popSQ(victim);
+        }
         board.popSQ(source);
         board.setSQ(target, type);
+        dirty.add(type, source, target);
     }
         
     else if (nature == Castle)
     {
+        auto rookSource = SOURCE_CASTLE[setup][gs.turn][move.castle()];
+        auto rookTarget = TARGET_CASTLE[setup][gs.turn][move.castle()];
+
         // Update King location
         board.popSQ(source);
         board.setSQ(target, PieceClass(King, gs.turn));
 
         // Update Rook location
-        board.popSQ(SOURCE_CASTLE[setup][gs.turn][move.castle()]);
-        board.setSQ(TARGET_CASTLE[setup][gs.turn][move.castle()], PieceClass(Rook, gs.turn));
+        board.popSQ(rookSource);
+        board.setSQ(rookTarget, PieceClass(Rook, gs.turn));
+
+        dirty.add(PieceClass(King, gs.turn), source, target);
+        dirty.add(PieceClass(Rook, gs.turn), rookSource, rookTarget);
     }
 
     else if (nature == Evolve)
     {
         board.popSQ(source);
-        board.popSQ(target);
+        if (take != EMPTY) board.popSQ(target);
         board.setSQ(target, move.evolve());
+        dirty.add(type, source, OFFBOARD);
+        if (take != EMPTY) dirty.add(take, target, OFFBOARD);
+        dirty.add(move.evolve(), OFFBOARD, target);
     }
 
     else // Jumper, Slider, Pushed, Strike
     {
-        board.popSQ(target);
+        if (take != EMPTY) board.popSQ(target);
         board.popSQ(source);
         board.setSQ(target, type);
+        if (take != EMPTY) dirty.add(take, target, OFFBOARD);
+        dirty.add(type, source, target);
     }
 
-    states.emplace_back(clock, next(gs.turn), hash, castle, take, enpass);
+    // Every board change is in the dirty list, hash those and the turn
+    for (int k = 0; k < dirty.size; ++k)
+        hash ^= ZOBRIST.piece[dirty.piece[k]][dirty.from[k]]
+              ^ ZOBRIST.piece[dirty.piece[k]][dirty.to[k]];
+
+    auto turn = next(gs.turn, gs.alive);
+    hash ^= ZOBRIST.turn[gs.turn] ^ ZOBRIST.turn[turn];
+
+    states.emplace_back(clock, turn, hash, castle, gs.alive, take, enpass, dirty);
+}
+
+void Position::eliminate() noexcept
+{
+    const GameState& gs = states.back();
+    assert(std::popcount(gs.alive) > 1);
+
+    uint8_t alive = gs.alive & ~aliveBit(gs.turn);
+    uint8_t castle = gs.castle & ~castleBit(gs.turn, KingSide) & ~castleBit(gs.turn, QueenSide);
+    auto turn = next(gs.turn, alive);
+
+    auto enpass = gs.enpass;
+    enpass[gs.turn] = OFFBOARD;
+
+    auto hash = gs.hash
+              ^ ZOBRIST.turn[gs.turn] ^ ZOBRIST.turn[turn]
+              ^ ZOBRIST.castle[gs.castle] ^ ZOBRIST.castle[castle]
+              ^ ZOBRIST.enpass[gs.enpass[gs.turn]]
+              ^ ZOBRIST.alive[gs.alive] ^ ZOBRIST.alive[alive];
+
+    states.emplace_back(gs.clock, turn, hash, castle, alive, EMPTY, enpass);
 }
 
 void Position::undomove(Move move)
@@ -86,7 +139,10 @@ void Position::undomove(Move move)
     {
         board.popSQ(target);
         board.setSQ(source, type);
-        board.setSQ(target + PUSH_DELTA[move.enpass()], PieceClass(Pawn, move.enpass()));
+
+        // The dirty list holds the taken pawn unless it was already gone
+        if (gs.dirty.size > 1)
+            board.setSQ(target + PUSH_DELTA[move.enpass()], PieceClass(Pawn, move.enpass()));
     }
 
     else if (nature == Castle)
@@ -95,25 +151,75 @@ void Position::undomove(Move move)
         board.popSQ(target);
         board.setSQ(source, type);
 
-        // Update Rook location
-        board.popSQ(TARGET_CASTLE[setup][gs.turn][move.castle()]);
-        board.setSQ(SOURCE_CASTLE[setup][gs.turn][move.castle()], PieceClass(Rook, type.color()));
+        // Update Rook location (gs.turn is already the next player here)
+        board.popSQ(TARGET_CASTLE[setup][type.color()][move.castle()]);
+        board.setSQ(SOURCE_CASTLE[setup][type.color()][move.castle()], PieceClass(Rook, type.color()));
     }
 
     else if (nature == Evolve)
     {
         board.popSQ(target);
         board.setSQ(source, PieceClass(Pawn, type.color()));
+        if (take != EMPTY) board.setSQ(target, take);
     }
 
     else // Jumper, Slider, Pushed, Stride, Strike
     {
         board.popSQ(target);
-        board.setSQ(target, take);
+        if (take != EMPTY) board.setSQ(target, take);
         board.setSQ(source, type);
     }
 
     states.pop_back();
 }
 
+// The same player is to move again after a full round, one ply per player
+// still in the game. An elimination changes the hash, so states from before
+// it never match whatever the round length was then.
+static inline std::size_t roundOf(const GameState& gs) noexcept {
+    return static_cast<std::size_t>(std::popcount(gs.alive));
+}
+
+bool Position::isRepetition(int play) const noexcept
+{
+    const GameState& gs = states.back();
+    const auto round = roundOf(gs);
+    auto end = std::min<std::size_t>(gs.clock, states.size() - 1);
+
+    int count = 0;
+    for (std::size_t i = round; i <= end; i += round)
+    {
+        if (states[states.size() - 1 - i].hash != gs.hash)
+            continue;
+
+        if (i < static_cast<std::size_t>(play) || ++count == 2)
+            return true;
+    }
+
+    return false;
+}
+
+bool Position::hasUpcomingRepetition(int play) const noexcept
+{
+    const GameState& gs = states.back();
+    const auto round = roundOf(gs);
+    auto end = std::min<std::size_t>({static_cast<std::size_t>(gs.clock), states.size() - 1, static_cast<std::size_t>(play) - 1});
+
+    // Cuckoo keys hand the turn to next(color), not to the next player alive
+    auto skip = ZOBRIST.turn[next(gs.turn)] ^ ZOBRIST.turn[next(gs.turn, gs.alive)];
+
+    // One move by the player to move reaches a position one ply short of
+    // a full round back
+    for (std::size_t i = round - 1; i <= end; i += round)
+    {
+        auto entry = CUCKOO.find(gs.hash ^ states[states.size() - 1 - i].hash ^ skip);
+        if (!entry) continue;
+
+        if (entry->line == Empty || !(between(entry->a, entry->b, entry->line) & board.everyone()))
+            return true;
+    }
+
+    return false;
+}
+
 } // namespace athena
\ No newline at end of file
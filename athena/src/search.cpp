@@ -4,15 +4,22 @@
 #include "eval.h"
 #include "chess.h"
 #include "position.h"
+#include "nnue/nnue.h"
+#include "stats.h"
+#include "trace.h"
+#include "utility.h"
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <sstream>
 
 
 namespace athena {
 
 // Search score constants and limits:
 // SCORE_INFINITY: upper bound for alpha-beta window; no reachable score exceeds this.
-// SCORE_CHECKMATE: returned when checkmate is imminent (just below infinity).
+// SCORE_CHECKMATE: score of a checkmate, negative for the mated side (just below infinity).
 // SCORE_DRAW: returned for draw conditions (fifty-move rule, stalemate).
 // MAX_PLAY: maximum ply depth to guard against infinite recursion (256 plies ≈ 128 moves).
 // MOVE_*: sentinel Move objects used to indicate game-end conditions (draw, checkmate, stalemate).
@@ -36,32 +43,80 @@ static inline int pieceValue(Piece p) {
     }
 }
 
+bool SearchControl::expired() const noexcept
+{
+    auto limit = deadline.load(std::memory_order_relaxed);
+    return limit != 0 && std::chrono::steady_clock::now().time_since_epoch().count() >= limit;
+}
+
+// A move that raised alpha heads the line from this ply, followed by the
+// line its child left one ply down
+static inline void updatePv(Thread& thread, int play, Move m) {
+    if (play >= MAX_PV) return;
+    const int length = play + 1 < MAX_PV ? std::min(thread.pvLength[play + 1], MAX_PV - 1) : 0;
+    thread.pvTable[play][0] = m;
+    std::copy_n(thread.pvTable[play + 1].begin(), length, thread.pvTable[play].begin() + 1);
+    thread.pvLength[play] = length + 1;
+}
+
+// Make/undo wrappers that keep the NNUE accumulator stack in step with the position.
+// push() only marks the new ply stale; accumulators are computed when evaluated.
+static inline void makemove(Position& pos, Thread& thread, Move m) {
+    STATS_TIMER(thread, MakeUndoTimer);
+    pos.makemove(m);
+    if (thread.nnue) thread.nnue->push();
+}
+
+static inline void undomove(Position& pos, Thread& thread, Move m) {
+    STATS_TIMER(thread, MakeUndoTimer);
+    pos.undomove(m);
+    if (thread.nnue) thread.nnue->pop();
+}
+
 // Fail-hard quiescence search: extends the search only for captures to avoid horizon effects.
-// Uses isRoyalSafe() to skip illegal moves that expose the king.
+// Uses isLegal() to skip moves that would leave the mover's king attacked.
 // Returns best score found within [alpha, beta); uses beta cutoff for alpha-beta pruning.
-static int quiesce(Position& pos, int alpha, int beta) {
+static int quiesce(Position& pos, Thread& thread, int alpha, int beta) {
+    STATS(++thread.stats.qnodes);
+
     // Evaluate current position (stand-pat).
     // If eval ≥ beta, we have a cutoff: this line is good enough to refute the parent move.
-    int standPat = evaluate(pos);
+    int standPat;
+    {
+        STATS_TIMER(thread, EvalTimer);
+        STATS(++thread.stats.evals);
+        standPat = evaluate(pos, thread, alpha, beta);
+    }
     if (standPat >= beta) return beta;
     if (standPat >  alpha) alpha = standPat;
 
+    // A game long enough to fill the state stack ends the line here
+    if (pos.states.full()) return alpha;
+
     // Generate and search all captures (noisy moves).
     Move moves[MAX_MOVES];
     int size = 0;
-    size += genAllNoisyMoves(pos, moves + size);
+    {
+        STATS_TIMER(thread, MovegenTimer);
+        size += genAllNoisyMoves(pos, moves + size);
+    }
+
+    const Guild us = toGuild(pos.states.back().turn);
 
     for (int i = 0; i < size; ++i) {
         Move m = moves[i];
-        pos.makemove(m);
-        if (!isRoyalSafe(pos, pos.states.back().turn)) {
-            pos.undomove(m);
+        if (!isLegal(pos, m)) {
+            STATS(++thread.stats.illegal);
             continue;
         }
-        int score = -quiesce(pos, -beta, -alpha);
+        makemove(pos, thread, m);
+        const bool ally = toGuild(pos.states.back().turn) == us;
+        int score = ally ? quiesce(pos, thread, alpha, beta)
+                         : -quiesce(pos, thread, -beta, -alpha);
+        undomove(pos, thread, m);
         // Fail-hard: update alpha if score improves, but never exceed beta.
+        if (score >= beta) return beta;
         if (score > alpha) alpha = score;
-        
     }
     return alpha;
 }
@@ -72,12 +127,34 @@ static int quiesce(Position& pos, int alpha, int beta) {
 // Uses MAX_PLAY as a safeguard against infinite recursion.
 // Sets thread.move and thread.score at root (play == 0) when a better move is found.
 int negamax(Position& pos, Thread& thread, int alpha, int beta, int depth, int play) {
-    thread.nodes++;
+    const std::uint64_t node = thread.nodes++;
+    const int alphaIn = alpha;
+    STATS(++thread.stats.nodes);
+
+    if (play < MAX_PV) thread.pvLength[play] = 0;
+
+    // A stopped search unwinds at once, its result is never used. The root
+    // still walks its moves so a search stopped early has one. The clock is
+    // only read every 1024 nodes.
+    if (thread.control && play > 0) {
+        if ((node & 1023) == 0 && thread.control->expired())
+            thread.control->stop.store(true, std::memory_order_relaxed);
+        if (thread.control->stop.load(std::memory_order_relaxed))
+            return 0;
+    }
+
+    // Every return goes through here so the node can be written to the search trace.
+    auto traced = [&](int score, Move best, TraceReason reason) {
+        if (thread.trace && thread.trace->wants(node, play))
+            thread.trace->push({node, alphaIn, beta, score, best,
+                                static_cast<std::uint16_t>(play), static_cast<std::int8_t>(depth), reason});
+        return score;
+    };
     
-    // Base case: depth ≤ 0 or MAX_PLAY safety limit reached; enter quiescence search.
+    // Base case: depth ≤ 0, MAX_PLAY safety limit or no room left on the state stack; enter quiescence search.
     // depth decremented each ply; play only guards MAX_PLAY (safety cap)
-    if (depth <= 0 || play >= MAX_PLAY)
-        return quiesce(pos, alpha, beta);
+    if (depth <= 0 || play >= MAX_PLAY || pos.states.full())
+        return traced(quiesce(pos, thread, alpha, beta), Move(), TraceLeaf);
 
     const GameState& gs = pos.states.back();
     // Fifty-move rule: draw if clock ≥ 100 half-moves (50 full moves without capture or pawn move).
@@ -86,13 +163,27 @@ int negamax(Position& pos, Thread& thread, int alpha, int beta, int depth, int p
             thread.score = SCORE_DRAW;
             thread.move  = MOVE_DRAW_FIFTY_MOVE;
         }
-        return SCORE_DRAW;
+        return traced(SCORE_DRAW, Move(), TraceFifty);
+    }
+
+    // Repetitions are draws; the player to move can also force one if a
+    // single move takes it back to a position of this search.
+    if (play > 0 && pos.isRepetition(play))
+        return traced(SCORE_DRAW, Move(), TraceRepetition);
+
+    if (play > 0 && alpha < SCORE_DRAW && pos.hasUpcomingRepetition(play)) {
+        alpha = SCORE_DRAW;
+        if (alpha >= beta)
+            return traced(alpha, Move(), TraceRepetition);
     }
 
     Move moves[MAX_MOVES];
     int size = 0;
-    size += genAllNoisyMoves(pos, moves + size);
-    size += genAllQuietMoves(pos, moves + size);
+    {
+        STATS_TIMER(thread, MovegenTimer);
+        size += genAllNoisyMoves(pos, moves + size);
+        size += genAllQuietMoves(pos, moves + size);
+    }
 
     // Move ordering using MVV-LVA: captures sorted by material gain (victim value - attacker value).
     // Quiet moves score 0; captures score 10000 + gain. Stable sort preserves move generator order.
@@ -106,48 +197,155 @@ int negamax(Position& pos, Thread& thread, int alpha, int beta, int depth, int p
                + pieceValue(pos.board[m.target()].piece())
                - pieceValue(pos.board[m.source()].piece());
         }
+        // At the root, lines already reported in MultiPV are skipped and
+        // the previous iteration's best moves go first, in their order
+        if (play == 0) {
+            if (std::ranges::find(thread.excluded, m) != thread.excluded.end())
+                continue;
+            auto it = std::ranges::find(thread.rootOrder, m);
+            if (it != thread.rootOrder.end())
+                sc = 20000 + static_cast<int>(thread.rootOrder.end() - it);
+        }
         ordered.emplace_back(sc, m);
     }
     std::stable_sort(ordered.begin(), ordered.end(),
                      [](const auto& a, const auto& b){ return a.first > b.first; });
 
-    bool anyLegal = false;
+    const Guild us = toGuild(gs.turn);
+    int legal = 0;
     int bestScore = -SCORE_INFINITY;
+    Move bestMove;
 
     for (const auto& it : ordered) {
         Move m = it.second;
-        pos.makemove(m);
-        if (!isRoyalSafe(pos, pos.states.back().turn)) {
-            pos.undomove(m);
+        if (!isLegal(pos, m)) {
+            STATS(++thread.stats.illegal);
             continue;
         }
-        anyLegal = true;
-        int score = -negamax(pos, thread, -beta, -alpha, depth - 1, play + 1);
-        pos.undomove(m);
+        makemove(pos, thread, m);
+        ++legal;
+        // Teams alternate until an elimination leaves two teammates moving
+        // one after the other; only a change of team flips the window.
+        const bool ally = toGuild(pos.states.back().turn) == us;
+        int score = ally ? negamax(pos, thread, alpha, beta, depth - 1, play + 1)
+                         : -negamax(pos, thread, -beta, -alpha, depth - 1, play + 1);
+        undomove(pos, thread, m);
         if (score > bestScore) {
             bestScore = score;
+            bestMove = m;
             // At root (play == 0), record the best move and score for engine output.
             if (play == 0) {
                 thread.score = bestScore;
                 thread.move  = m;
-                thread.pv.clear();
-                thread.pv.push_back(m);
             }
         }
+        // Raise the lower bound so later siblings are searched with a narrower window.
+        if (score > alpha) {
+            alpha = score;
+            updatePv(thread, play, m);
+            if (play == 0)
+                thread.pv.assign(thread.pvTable[0].begin(), thread.pvTable[0].begin() + thread.pvLength[0]);
+        }
         // Fail-hard beta cutoff: if score ≥ beta, return immediately (prune remaining moves).
-        if (score >= beta) return beta;
-        
+        if (score >= beta) {
+            STATS(++thread.stats.cutoffs);
+            STATS(++thread.stats.cutoffIndex[std::min(legal, SearchStats::CUTOFF_BUCKETS) - 1]);
+            return traced(beta, m, TraceCutoff);
+        }
     }
-    if (!anyLegal) {
+    if (legal == 0) {
         if (isRoyalSafe(pos, pos.states.back().turn)) {
             if (play == 0) { thread.score = SCORE_DRAW; thread.move = MOVE_STALEMATE; }
-            return SCORE_DRAW;
+            return traced(SCORE_DRAW, Move(), TraceStalemate);
         } else {
-            if (play == 0) { thread.score = SCORE_CHECKMATE; thread.move = MOVE_CHECKMATE; }
-            return SCORE_CHECKMATE;
+            if (play == 0) { thread.score = -SCORE_CHECKMATE; thread.move = MOVE_CHECKMATE; }
+            return traced(-SCORE_CHECKMATE, Move(), TraceCheckmate);
         }
     }
-    return bestScore;
+    return traced(bestScore, bestMove, TraceAll);
+}
+
+int search(Position& pos, Thread& thread, SearchControl& control, std::ostream& output) {
+    using namespace std::chrono;
+    const auto start = steady_clock::now();
+
+    thread.control = &control;
+
+    // No more lines than legal root moves, excluding them all would look
+    // like a mate. A root without moves still gets its one line.
+    int roots = 0;
+    {
+        Move moves[MAX_MOVES];
+        int size = 0;
+        size += genAllNoisyMoves(pos, moves + size);
+        size += genAllQuietMoves(pos, moves + size);
+        for (int i = 0; i < size; ++i) roots += isLegal(pos, moves[i]);
+    }
+    const int count = std::clamp(roots, 1, std::max(control.multipv, 1));
+
+    // Lines of the deepest finished iteration, best first
+    struct Line {
+        int score;
+        Move move;
+        std::vector<Move> pv;
+    };
+    std::vector<Line> lines, found;
+
+    for (int depth = 1; depth <= control.depth.load(); ++depth) {
+        // Each line searches the root without the moves of the lines above it
+        found.clear();
+        thread.excluded.clear();
+        for (int k = 0; k < count; ++k) {
+            int value = negamax(pos, thread, -SCORE_INFINITY, SCORE_INFINITY, depth, 0);
+            if (control.stop.load() && (depth > 1 || k > 0))
+                break;
+            found.push_back({value, thread.move, thread.pv});
+            thread.excluded.push_back(thread.move);
+        }
+        thread.excluded.clear();
+
+        // The first iteration is kept even when cut short, so there is a move
+        if (control.stop.load() && depth > 1)
+            break;
+
+        lines = found;
+        control.completed = depth;
+
+        thread.rootOrder.clear();
+        for (const auto& line : lines) thread.rootOrder.push_back(line.move);
+
+        const auto ms  = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        const auto nps = ms > 0 ? thread.nodes * 1000 / ms : 0;
+
+        // One write per iteration, the engine answers isready while this runs
+        std::ostringstream info;
+        for (std::size_t k = 0; k < lines.size(); ++k) {
+            info << "info depth " << depth
+                 << " multipv " << k + 1
+                 << " score cp " << lines[k].score
+                 << " nodes " << thread.nodes
+                 << " time " << ms
+                 << " nps " << nps
+                 << " pv";
+            for (Move m : lines[k].pv) info << ' ' << toString(m);
+            info << '\n';
+        }
+        output << info.str() << std::flush;
+
+        if (control.stop.load())
+            break;
+    }
+
+    thread.rootOrder.clear();
+    thread.control = nullptr;
+
+    if (lines.empty())
+        return thread.score;
+
+    thread.score = lines[0].score;
+    thread.move  = lines[0].move;
+    thread.pv    = lines[0].pv;
+    return thread.score;
 }
 
-} // namespace athena
\ No newline at end of file
+} // namespace athena
@@ -0,0 +1,49 @@
+#include "stats.h"
+
+namespace athena
+{
+
+SearchStats& SearchStats::operator+=(const SearchStats& other)
+{
+    nodes += other.nodes;
+    qnodes += other.qnodes;
+    illegal += other.illegal;
+    evals += other.evals;
+    cutoffs += other.cutoffs;
+
+    for (int i = 0; i < CUTOFF_BUCKETS; ++i)
+        cutoffIndex[i] += other.cutoffIndex[i];
+
+    for (int i = 0; i < TIMER_NB; ++i)
+        cycles[i] += other.cycles[i];
+
+    return *this;
+}
+
+void SearchStats::report(std::ostream& output) const
+{
+    auto percent = [](uint64_t part, uint64_t whole) {
+        return whole ? 100 * part / whole : 0;
+    };
+
+    output << "info string stats nodes " << nodes
+           << " qnodes " << qnodes
+           << " illegal " << illegal
+           << " evals " << evals << "\n";
+
+    output << "info string stats cutoffs " << cutoffs
+           << " first " << percent(cutoffIndex[0], cutoffs) << "%"
+           << " index";
+    for (auto count : cutoffIndex) output << " " << count;
+    output << "\n";
+
+    uint64_t total = cycles[MovegenTimer] + cycles[EvalTimer] + cycles[MakeUndoTimer];
+    output << "info string stats cycles movegen " << cycles[MovegenTimer]
+           << " (" << percent(cycles[MovegenTimer], total) << "%)"
+           << " eval " << cycles[EvalTimer]
+           << " (" << percent(cycles[EvalTimer], total) << "%)"
+           << " makeundo " << cycles[MakeUndoTimer]
+           << " (" << percent(cycles[MakeUndoTimer], total) << "%)" << std::endl;
+}
+
+} // namespace athena
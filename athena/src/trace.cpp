@@ -0,0 +1,95 @@
+#include "trace.h"
+#include "utility.h"
+#include <chrono>
+
+namespace athena
+{
+
+constexpr std::string_view TRACE_REASONS[TRACE_REASON_NB] =
+{
+    "leaf", "cutoff", "all", "checkmate", "stalemate", "fifty", "repetition"
+};
+
+TraceRing::TraceRing(std::size_t capacity)
+{
+    std::size_t size = 1;
+    while (size < capacity) size *= 2;
+
+    records = std::make_unique<TraceRecord[]>(size);
+    mask = size - 1;
+}
+
+Tracer::~Tracer()
+{
+    stop();
+}
+
+void Tracer::start(const std::string& path, std::string_view fen, int threads, uint64_t sample, int maxPly)
+{
+    stop();
+
+    file.open(path, std::ios::app);
+    if (!file)
+        throw std::invalid_argument("cannot open trace file: " + path);
+
+    file << "{\"fen\":\"" << fen << "\"}\n";
+
+    // 64K records (2 MB) per thread, a few milliseconds of search
+    rings.clear();
+    for (int i = 0; i < threads; ++i)
+    {
+        rings.push_back(std::make_unique<TraceRing>(1 << 16));
+        rings.back()->sample = std::max<uint64_t>(sample, 1);
+        rings.back()->maxPly = maxPly;
+    }
+
+    running = true;
+    writer = std::thread([this]()
+    {
+        while (running.load(std::memory_order_acquire))
+            if (flush() == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+}
+
+uint64_t Tracer::stop()
+{
+    if (!writer.joinable()) return 0;
+
+    running = false;
+    writer.join();
+    flush();
+    file.close();
+
+    uint64_t dropped = 0;
+    for (const auto& ring : rings) dropped += ring->droppedCount();
+    return dropped;
+}
+
+std::size_t Tracer::flush()
+{
+    char move[MAX_MOVE_LENGTH + 1];
+    std::size_t total = 0;
+
+    for (std::size_t i = 0; i < rings.size(); ++i)
+    {
+        total += rings[i]->drain([&](const TraceRecord& r)
+        {
+            auto end = r.move.source() == OFFBOARD ? move : toString(r.move, move);
+
+            file << "{\"thread\":" << i
+                 << ",\"node\":" << r.node
+                 << ",\"ply\":" << r.ply
+                 << ",\"depth\":" << int(r.depth)
+                 << ",\"alpha\":" << r.alpha
+                 << ",\"beta\":" << r.beta
+                 << ",\"score\":" << r.score
+                 << ",\"move\":\"" << std::string_view(move, end - move)
+                 << "\",\"reason\":\"" << TRACE_REASONS[r.reason] << "\"}\n";
+        });
+    }
+
+    return total;
+}
+
+} // namespace athena
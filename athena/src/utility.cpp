@@ -4,95 +4,154 @@
 namespace athena
 {
 
-std::string toString(const Position& pos)
+char* toString(const Position& pos, char* buffer) noexcept
 {
     const GameState& gs = pos.states.back();
 
-    std::string tn = ""; 
-    tn += toString(pos.setup) + " ";
-    tn += toString(gs.turn)   + " ";
-    tn += toString(gs.clock)  + " "; 
-    tn += toString(gs.castle, pos.setup, KingSide)  + " ";
-    tn += toString(gs.castle, pos.setup, QueenSide) + " ";
-    tn += toString(gs.enpass) + " ";
+    constexpr std::string_view COLOR_CHAR = "rbyg";
+    constexpr std::string_view PIECE_CHAR = "knbrqp";
+
+    auto out = buffer;
+    auto put = [&](std::string_view str) { out = std::copy(str.begin(), str.end(), out); };
+    auto num = [&](int value) { out = std::to_chars(out, out + 11, value).ptr; };
+
+    put(pos.setup == Classic ? "classic " : "modern ");
+    *out++ = COLOR_CHAR[gs.turn];
+    *out++ = ' ';
+    num(gs.clock);
+
+    for (auto side: SIDES)
+    {
+        *out++ = ' ';
+        for (auto color: COLORS)
+            *out++ = (gs.castle & castleBit(color, side)) ? '1' : '0';
+    }
+
+    for (auto color: COLORS)
+    {
+        *out++ = color == Red ? ' ' : ',';
+        if (gs.enpass[color] == OFFBOARD) *out++ = '-';
+        else
+        {
+            *out++ = static_cast<char>('a' + fileSQ(gs.enpass[color]));
+            num(rankSQ(gs.enpass[color]) + 1);
+        }
+    }
+
+    *out++ = ' ';
 
     int counter = 0;
     for (auto sq: VALID_SQUARES)
     {
-        const auto& pc = pos.board[sq];
+        auto pc = pos.board[sq];
         if (pc == EMPTY)
         {
             ++counter;
             continue;
         }
-        
+
         if (counter > 0)
         {
-            tn += std::to_string(counter) + ",";
+            num(counter);
+            *out++ = ',';
             counter = 0;
         }
 
-        else tn += toString(pc) + ",";
+        *out++ = COLOR_CHAR[pc.color()];
+        *out++ = PIECE_CHAR[pc.piece()];
+        *out++ = ',';
     }
 
-    if (counter > 0)
-        tn += std::to_string(counter);
+    if (counter > 0) num(counter);
+    else if (out[-1] == ',') --out;
 
-    if (tn.back() == ',')
-        tn.pop_back();
+    // Only games with eliminated players carry the optional last field
+    if (gs.alive != ALL_ALIVE)
+    {
+        *out++ = ' ';
+        for (auto color: COLORS)
+            *out++ = (gs.alive & aliveBit(color)) ? '1' : '0';
+    }
 
-    return tn;
+    return out;
 }
 
-void fromString(const std::string& str, Position& pos)
+std::string toString(const Position& pos)
 {
-    pos.states.clear();
-    pos.states.reserve(256);
+    char buffer[MAX_FEN_LENGTH];
+    return std::string(buffer, toString(pos, buffer));
+}
 
-    // <GameSetup> <Turn> <Clock> <KingSide> <QueenSide> <Enpassant> <Board>
-    auto tokens = tokenize(str, ' ');
+void fromString(std::string_view str, Position& pos)
+{
+    // <GameSetup> <Turn> <Clock> <KingSide> <QueenSide> <Enpassant> <Board> [<Alive>]
+    std::string_view fields[7];
+    for (auto& field: fields)
+        if ((field = nextToken(str)).empty())
+            throw std::invalid_argument("expected 7 FEN fields");
 
-    // Parsing <GameSetup>
-    fromString(tokens[0], pos.setup);
+    uint8_t alive = ALL_ALIVE;
+    if (auto field = nextToken(str); !field.empty())
+        fromString(field, alive);
+
+    GameSetup setup;
+    fromString(fields[0], setup);
 
-    // Parsing <Turn>
     Color turn;
-    fromString(tokens[1], turn);
+    fromString(fields[1], turn);
+    if (turn == None || fields[1].size() != 1 || !(alive & aliveBit(turn)))
+        throw std::invalid_argument("invalid turn: " + std::string(fields[1]));
 
-    // Parsing <Clock>
     int clock;
-    fromString(tokens[2], clock);
+    fromString(fields[2], clock);
 
-    // Parsing <KingSide> <QueenSide>
-    BitBoard castle;
-    fromString(tokens[3], castle, pos.setup, KingSide);
-    fromString(tokens[4], castle, pos.setup, QueenSide);
+    uint8_t castle = 0;
+    fromString(fields[3], castle, KingSide);
+    fromString(fields[4], castle, QueenSide);
 
-    // Parsing <Enpassant>
     ndarray<Square, COLOR_NB - 1> enpass;
-    fromString(tokens[5], enpass);
+    fromString(fields[5], enpass);
 
-    // Parsing <Board>
-    auto board = tokenize(tokens[6], ',');
-    pos.board.clear();
-    int idx = 0;
-    for (auto sq : board)
+    // Pieces and runs of empty squares in VALID_SQUARES order, scanned a
+    // character at a time since this field is most of the string
+    Board board;
+    std::size_t idx = 0;
+    for (auto it = fields[6].data(), end = it + fields[6].size(); it < end; )
     {
-        if (!std::isdigit(sq[0]))
+        if (*it == ',')
         {
-            PieceClass pc;
-            fromString(sq, pc);
-            pos.board.setSQ(VALID_SQUARES[idx++], pc);
+            ++it;
+            continue;
         }
-        // else idx += std::stoi(sq);
-        else {
-            int skip = std::stoi(sq);
-            for (int i = 0; i < skip; ++i)
-                pos.board.setSQ(VALID_SQUARES[idx++], EMPTY);
+
+        if (std::isdigit(static_cast<unsigned char>(*it)))
+        {
+            int skip;
+            it = std::from_chars(it, end, skip).ptr;
+            idx += skip;
+            continue;
         }
+
+        auto size = std::min<std::ptrdiff_t>(end - it, 2);
+        std::string_view token(it, size);
+
+        PieceClass pc;
+        fromString(token, pc);
+        if (pc.piece() == Empty || pc.color() == None || idx >= BOARDSIZE || (it + size < end && it[size] != ','))
+            throw std::invalid_argument("invalid board entry: " + std::string(token));
+
+        board.setSQ(VALID_SQUARES[idx++], pc);
+        it += size;
     }
 
-    pos.states.emplace_back(clock, turn, BB(), castle, EMPTY, enpass);
+    if (idx > BOARDSIZE)
+        throw std::invalid_argument("board has more than 160 squares");
+
+    pos.setup = setup;
+    pos.board = board;
+    pos.states.clear();
+    pos.states.emplace_back(clock, turn, 0, castle, alive, EMPTY, enpass);
+    pos.states.back().hash = computeHash(pos);
 }
 
 } // namespace athena
\ No newline at end of file
@@ -3,4 +3,56 @@
 namespace athena
 {
 
-} // namespace athena
\ No newline at end of file
+uint64_t computeHash(const Position& pos)
+{
+    const GameState& gs = pos.states.back();
+
+    uint64_t hash = ZOBRIST.turn[gs.turn];
+
+    for (auto sq : pos.board.everyone())
+        hash ^= ZOBRIST.piece[pos.board[sq]][sq];
+
+    hash ^= ZOBRIST.castle[gs.castle];
+    hash ^= ZOBRIST.alive[gs.alive];
+
+    for (auto sq : gs.enpass)
+        hash ^= ZOBRIST.enpass[sq];
+
+    return hash;
+}
+
+CuckooTable::CuckooTable()
+{
+    for (auto color : COLORS)
+    for (auto piece : {Knight, Bishop, Rook, Queen, King})
+    {
+        PieceClass pc(piece, color);
+
+        for (auto a : VALID_SQUARES)
+        for (auto b : piece == Queen ? PIECE_ATTACK[Rook][a] | PIECE_ATTACK[Bishop][a] : PIECE_ATTACK[piece][a])
+        {
+            if (b <= a) continue;
+
+            Entry entry;
+            entry.key = ZOBRIST.piece[pc][a] ^ ZOBRIST.piece[pc][b] ^ ZOBRIST.turn[color] ^ ZOBRIST.turn[next(color)];
+            entry.a = a;
+            entry.b = b;
+            entry.line = piece == Knight || piece == King ? Empty
+                       : PIECE_ATTACK[Rook][a].checkSQ(b) ? Rook : Bishop;
+
+            // Kick entries back and forth between their two slots until one lands empty
+            auto slot = CuckooTable::h1(entry.key);
+            while (true)
+            {
+                std::swap(entries[slot], entry);
+                if (entry.key == 0) break;
+                slot = slot == h1(entry.key) ? h2(entry.key) : h1(entry.key);
+            }
+            ++size;
+        }
+    }
+}
+
+const CuckooTable CUCKOO;
+
+} // namespace athena
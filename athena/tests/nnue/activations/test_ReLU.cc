@@ -8,10 +8,10 @@ TEST(TestReLU, Propagate)
     int output[size] = {};
 
     athena::ReLU<size> ReLU;
-    ReLU.propagatge(input, output);
+    ReLU.propagate(input, output);
 
     const int expected[] = {0, 0, 5, 0, 7};
-    for (int i = 0; i < size; ++i)
+    for (std::size_t i = 0; i < size; ++i)
     {
         EXPECT_EQ(output[i], expected[i]);
     }
@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+#include "nnue/activations/nnue_clipped_ReLU.h"
+
+TEST(TestClippedReLU, Propagate)
+{
+    constexpr std::size_t size = 5;
+    const int32_t input[] = {-3, 0, 5, 200, 127};
+    int32_t output[size] = {};
+
+    athena::ClippedReLU<size> relu;
+    relu.propagate(input, output);
+
+    const int32_t expected[] = {0, 0, 5, 127, 127};
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        EXPECT_EQ(output[i], expected[i]);
+    }
+}
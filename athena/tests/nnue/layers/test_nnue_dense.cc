@@ -40,3 +40,63 @@ TEST(TestDense, Propagate)
     EXPECT_EQ(output[0], 24);
     EXPECT_EQ(output[1], 52);
 }
+
+TEST(TestDense, PropagateBatch)
+{
+    constexpr std::size_t inSize = 7;
+    constexpr std::size_t outSize = 3;
+    constexpr std::size_t batch = 6; // one full block of four plus a tail
+
+    Dense<inSize, outSize> dense;
+
+    for (std::size_t i = 0; i < outSize; ++i)
+    {
+        auto row = static_cast<int32_t>(i);
+        dense.biases()[i] = row - 1;
+        for (std::size_t j = 0; j < inSize; ++j)
+            dense.weights()[i][j] = (row + 1) * (static_cast<int32_t>(j) - 3);
+    }
+
+    int32_t input[batch * inSize];
+    for (std::size_t k = 0; k < batch * inSize; ++k)
+        input[k] = static_cast<int32_t>((k * 7) % 11) - 5;
+
+    int32_t output[batch * outSize] = {};
+    dense.propagate(input, output, batch);
+
+    for (std::size_t b = 0; b < batch; ++b)
+    {
+        int32_t expected[outSize] = {};
+        dense.propagate(input + b * inSize, expected);
+
+        for (std::size_t i = 0; i < outSize; ++i)
+            EXPECT_EQ(output[b * outSize + i], expected[i]) << "row " << b << ", output " << i;
+    }
+}
+
+TEST(TestDense, PropagateSkipsZeroBlocks)
+{
+    constexpr std::size_t inSize = 20; // two full blocks and a partial one
+    constexpr std::size_t outSize = 2;
+
+    Dense<inSize, outSize> dense;
+
+    for (std::size_t i = 0; i < outSize; ++i)
+    {
+        auto row = static_cast<int32_t>(i);
+        dense.biases()[i] = 5 * row;
+        for (std::size_t j = 0; j < inSize; ++j)
+            dense.weights()[i][j] = (row + 1) * static_cast<int32_t>(j);
+    }
+
+    // Only the second block and the partial tail are non-zero
+    int32_t input[inSize] = {};
+    input[9] = 2;
+    input[19] = -1;
+
+    int32_t output[outSize] = {};
+    dense.propagate(input, output);
+
+    EXPECT_EQ(output[0], 0 + 1 * 9 * 2 - 1 * 19);
+    EXPECT_EQ(output[1], 5 + 2 * 9 * 2 - 2 * 19);
+}
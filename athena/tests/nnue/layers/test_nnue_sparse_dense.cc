@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "nnue/layers/nnue_sparse_dense.h"
+
+using namespace athena;
+
+TEST(TestSparseDense, Propagate)
+{
+    constexpr std::size_t inSize = 5;
+    constexpr std::size_t outSize = 2;
+
+    SparseDense<inSize, outSize> dense;
+
+    // Column-major: weights[input][output]
+    auto &weights = dense.weights();
+    for (std::size_t j = 0; j < inSize; ++j)
+    {
+        auto column = static_cast<int32_t>(j) + 1;
+        weights[j][0] = column;
+        weights[j][1] = 10 * column;
+    }
+
+    auto &biases = dense.biases();
+    biases[0] = 100;
+    biases[1] = 200;
+
+    // Active inputs 1 and 3, i.e. the one-hot vector {0, 1, 0, 1, 0}
+    const int indices[] = {1, 3};
+    int32_t output[outSize] = {};
+
+    dense.propagate(indices, 2, output);
+
+    EXPECT_EQ(output[0], 100 + 2 + 4);
+    EXPECT_EQ(output[1], 200 + 20 + 40);
+}
+
+TEST(TestSparseDense, AddSub)
+{
+    SparseDense<3, 2> dense;
+    dense.weights()[2][0] = 7;
+    dense.weights()[2][1] = -3;
+
+    int32_t output[2] = {1, 1};
+
+    dense.add(2, output);
+    EXPECT_EQ(output[0], 8);
+    EXPECT_EQ(output[1], -2);
+
+    dense.sub(2, output);
+    EXPECT_EQ(output[0], 1);
+    EXPECT_EQ(output[1], 1);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include "nnue/nnue.h"
+#include "movegen.h"
+#include "utility.h"
+
+
+namespace athena
+{
+
+    template <typename Arch>
+    class TestAccumulator : public ::testing::Test
+    {
+    protected:
+        Model<Arch> nnue;
+        std::mt19937 rng{2025};
+
+        void SetUp() override
+        {
+            std::uniform_int_distribution<int32_t> dist(-64, 64);
+
+            std::vector<int32_t> params(Model<Arch>::Parameters);
+            for (auto &p : params)
+                p = dist(rng);
+
+            std::stringstream stream(std::string(reinterpret_cast<const char *>(params.data()), params.size() * sizeof(int32_t)));
+            ASSERT_TRUE(nnue.read(stream));
+        }
+
+        int32_t fresh(const Position &pos)
+        {
+            // Copy weights into a second network that always refreshes
+            Model<Arch> other;
+            other.input() = nnue.input();
+            other.output() = nnue.output();
+            other.reset();
+            return other.evaluate(pos);
+        }
+
+        int legalMoves(Position &pos, Move *legal)
+        {
+            Move moves[MAX_MOVES];
+            int size = 0;
+            size += genAllNoisyMoves(pos, moves + size);
+            size += genAllQuietMoves(pos, moves + size);
+
+            int count = 0;
+            for (int i = 0; i < size; ++i)
+            {
+                pos.makemove(moves[i]);
+                if (isRoyalSafe(pos, pos.states[pos.states.size() - 2].turn))
+                    legal[count++] = moves[i];
+                pos.undomove(moves[i]);
+            }
+            return count;
+        }
+    };
+
+    using ArchitectureTypes = ::testing::Types<Arch128, Arch512x16, Arch256x32x32>;
+    TYPED_TEST_SUITE(TestAccumulator, ArchitectureTypes);
+
+    TYPED_TEST(TestAccumulator, LazyMatchesRefresh)
+    {
+        Position pos;
+        fromString("modern R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bk,bp,10,gp,gq,bq,bp,10,gp,gk,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr", pos);
+        this->nnue.reset();
+
+        std::vector<Move> line;
+        for (int step = 0; step < 400; ++step)
+        {
+            Move legal[MAX_MOVES];
+            int size = this->legalMoves(pos, legal);
+
+            // Mostly descend, sometimes back up to exercise stale entries
+            bool down = size > 0 && (line.empty() || this->rng() % 4 != 0);
+            if (down)
+            {
+                Move move = legal[this->rng() % size];
+                pos.makemove(move);
+                this->nnue.push();
+                line.push_back(move);
+            }
+            else if (!line.empty())
+            {
+                pos.undomove(line.back());
+                this->nnue.pop();
+                line.pop_back();
+            }
+
+            // Skip evaluation at some nodes so several deltas pile up
+            if (this->rng() % 3 == 0)
+            {
+                ASSERT_EQ(this->nnue.evaluate(pos), this->fresh(pos)) << "mismatch at step " << step;
+            }
+        }
+    }
+
+} // namespace athena
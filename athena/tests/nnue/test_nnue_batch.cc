@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include "nnue/nnue.h"
+#include "movegen.h"
+#include "utility.h"
+
+namespace athena
+{
+
+    template <typename Arch>
+    class TestBatch : public ::testing::Test
+    {
+    };
+
+    using ArchitectureTypes = ::testing::Types<Arch128, Arch512x16, Arch256x32x32>;
+    TYPED_TEST_SUITE(TestBatch, ArchitectureTypes);
+
+    TYPED_TEST(TestBatch, MatchesSingleEvaluation)
+    {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int32_t> dist(-64, 64);
+
+        Model<TypeParam> nnue;
+        std::vector<int32_t> params(Model<TypeParam>::Parameters);
+        for (auto &p : params)
+            p = dist(rng);
+
+        std::stringstream stream(std::string(reinterpret_cast<const char *>(params.data()), params.size() * sizeof(int32_t)));
+        ASSERT_TRUE(nnue.read(stream));
+
+        // Positions along a random game, so piece counts vary across the batch
+        std::vector<Position> positions(BatchSize + 13);
+        Position pos;
+        fromString("classic R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bq,bp,10,gp,gk,bk,bp,10,gp,gq,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr", pos);
+
+        for (auto &p : positions)
+        {
+            Move moves[MAX_MOVES];
+            int size = 0;
+            size += genAllNoisyMoves(pos, moves + size);
+            size += genAllQuietMoves(pos, moves + size);
+            for (int tries = 0; size > 0 && tries < size; ++tries)
+            {
+                Move move = moves[rng() % size];
+                pos.makemove(move);
+                if (isRoyalSafe(pos, pos.states[pos.states.size() - 2].turn))
+                    break;
+                pos.undomove(move);
+            }
+            p = pos;
+        }
+
+        std::vector<int32_t> scores(positions.size());
+        nnue.evaluate(positions.data(), positions.size(), scores.data());
+
+        for (std::size_t i = 0; i < positions.size(); ++i)
+        {
+            nnue.reset();
+            EXPECT_EQ(scores[i], nnue.evaluate(positions[i])) << "position " << i;
+        }
+    }
+
+} // namespace athena
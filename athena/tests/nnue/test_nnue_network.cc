@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include "nnue/nnue.h"
+
+using namespace athena;
+
+TEST(TestNetwork, StackMatchesLayerByLayer)
+{
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int32_t> dist(-16, 16);
+
+    Network<ClippedReLU<16>, Dense<16, 8>, ClippedReLU<8>, Dense<8, 1>> network;
+    static_assert(decltype(network)::Parameters == 16 * 8 + 8 + 8 + 1);
+
+    for (auto &row : network.layer<1>().weights())
+        for (auto &w : row)
+            w = dist(rng);
+    for (auto &b : network.layer<1>().biases())
+        b = dist(rng);
+    for (auto &w : network.output().weights()[0])
+        w = dist(rng);
+    network.output().biases()[0] = dist(rng);
+
+    int32_t input[16];
+    for (auto &x : input)
+        x = dist(rng) * 16;
+
+    int32_t a1[16], z2[8], a2[8], z3[1];
+    network.layer<0>().propagate(input, a1);
+    network.layer<1>().propagate(a1, z2);
+    network.layer<2>().propagate(z2, a2);
+    network.layer<3>().propagate(a2, z3);
+
+    EXPECT_EQ(network.propagate(input), z3[0]);
+
+    int32_t batched[1];
+    network.propagate(input, batched, 1);
+    EXPECT_EQ(batched[0], z3[0]);
+}
+
+TEST(TestNetwork, BatchLargerThanScratchIsSplit)
+{
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int32_t> dist(-16, 16);
+
+    Network<ClippedReLU<8>, Dense<8, 4>, ClippedReLU<4>, Dense<4, 1>> network;
+    for (auto &row : network.layer<1>().weights())
+        for (auto &w : row)
+            w = dist(rng);
+    for (auto &w : network.output().weights()[0])
+        w = dist(rng);
+
+    constexpr std::size_t rows = 2 * BatchSize + 5;
+    std::vector<int32_t> input(rows * 8);
+    for (auto &x : input)
+        x = dist(rng) * 16;
+
+    std::vector<int32_t> batched(rows);
+    network.propagate(input.data(), batched.data(), rows);
+
+    for (std::size_t b = 0; b < rows; ++b)
+        EXPECT_EQ(batched[b], network.propagate(&input[b * 8])) << "row " << b;
+}
+
+TEST(TestNetwork, LoadSelectsArchitectureFromHeader)
+{
+    auto write = [](const std::string &path, uint32_t id, std::size_t parameters)
+    {
+        std::ofstream file(path, std::ios::binary);
+        uint32_t header[3] = {NetworkMagic, NetworkVersion, id};
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        std::vector<int32_t> zeros(parameters, 0);
+        file.write(reinterpret_cast<const char *>(zeros.data()), zeros.size() * sizeof(int32_t));
+    };
+
+    std::string path = ::testing::TempDir() + "athena_arch.nnue";
+    NNUE nnue;
+
+    write(path, Arch512x16::Id, Model<Arch512x16>::Parameters);
+    ASSERT_TRUE(nnue.load(path));
+    EXPECT_STREQ(nnue.architecture(), Arch512x16::Name);
+
+    write(path, Arch256x32x32::Id, Model<Arch256x32x32>::Parameters);
+    ASSERT_TRUE(nnue.load(path));
+    EXPECT_STREQ(nnue.architecture(), Arch256x32x32::Name);
+
+    // Parameters sized for another architecture are rejected
+    write(path, Arch128::Id, Model<Arch512x16>::Parameters);
+    EXPECT_FALSE(nnue.load(path));
+    EXPECT_FALSE(nnue.loaded());
+
+    // Unknown architecture id
+    write(path, 0xFFFF, Model<Arch128>::Parameters);
+    EXPECT_FALSE(nnue.load(path));
+
+    std::remove(path.c_str());
+}
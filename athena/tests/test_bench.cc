@@ -0,0 +1,16 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "bench.h"
+
+using namespace athena;
+
+TEST(TestBench, SignatureIndependentOfThreads)
+{
+    std::ostringstream single, multi;
+
+    auto nodes = runBench(single, 2, 1);
+    EXPECT_GT(nodes, 0);
+    EXPECT_EQ(runBench(multi, 2, 3), nodes);
+
+    EXPECT_NE(single.str().find("total: " + std::to_string(nodes) + " nodes"), std::string::npos);
+}
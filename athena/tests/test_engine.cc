@@ -0,0 +1,294 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "engine.h"
+
+using namespace athena;
+
+// Collects everything the engine prints while it lives
+struct CaptureOutput
+{
+    std::ostringstream out;
+    std::streambuf* saved = std::cout.rdbuf(out.rdbuf());
+
+    ~CaptureOutput() { std::cout.rdbuf(saved); }
+
+    // Takes the output so far, later calls only see what follows
+    std::string take()
+    {
+        auto text = out.str();
+        out.str("");
+        return text;
+    }
+};
+
+static std::vector<std::string> linesStarting(const std::string& text, std::string_view prefix)
+{
+    std::vector<std::string> lines;
+    std::istringstream input(text);
+    for (std::string line; std::getline(input, line); )
+        if (line.starts_with(prefix)) lines.push_back(line);
+    return lines;
+}
+
+// Moves after "pv" on the last info line
+static std::vector<std::string> lastPv(const std::string& text)
+{
+    auto info = linesStarting(text, "info depth");
+    if (info.empty()) return {};
+
+    std::istringstream line(info.back());
+    std::string word;
+    while (line >> word && word != "pv") {}
+
+    std::vector<std::string> moves;
+    while (line >> word) moves.push_back(word);
+    return moves;
+}
+
+TEST(TestEngine, PonderSearchesFromTheEndOfTheExpectedLine)
+{
+    CaptureOutput capture;
+    Engine engine;
+
+    engine.dispatch("position classic");
+    engine.dispatch("go depth 4");
+    engine.dispatch("position classic"); // waits for the search
+    auto pv = lastPv(capture.take());
+    ASSERT_GE(pv.size(), 4);
+
+    // Our own move after the three replies of the line
+    Engine other;
+    auto line = pv[0] + " " + pv[1] + " " + pv[2] + " " + pv[3];
+    other.dispatch("position classic moves " + line);
+    other.dispatch("go depth 2");
+    other.dispatch("position classic");
+    auto reference = linesStarting(capture.take(), "bestmove");
+    ASSERT_EQ(reference.size(), 1);
+
+    // Two replies are known, the ponder search plays the other two itself
+    engine.dispatch("position classic moves " + pv[0] + " " + pv[1]);
+    engine.dispatch("go ponder depth 2");
+    engine.dispatch("ponderhit");
+    engine.dispatch("position classic");
+    auto bestmove = linesStarting(capture.take(), "bestmove");
+    ASSERT_EQ(bestmove.size(), 1);
+    EXPECT_EQ(bestmove[0].substr(0, bestmove[0].find(" ponder")), reference[0].substr(0, reference[0].find(" ponder")));
+}
+
+TEST(TestEngine, StopAnswersAPonderSearch)
+{
+    CaptureOutput capture;
+    Engine engine;
+
+    engine.dispatch("position classic");
+    engine.dispatch("go depth 4");
+    engine.dispatch("position classic");
+    auto pv = lastPv(capture.take());
+    ASSERT_GE(pv.size(), 4);
+
+    auto line = pv[0] + " " + pv[1] + " " + pv[2] + " " + pv[3];
+    engine.dispatch("position classic moves " + pv[0] + " " + pv[1]);
+    engine.dispatch("go ponder");
+    engine.dispatch("stop");
+    auto bestmove = linesStarting(capture.take(), "bestmove");
+    ASSERT_EQ(bestmove.size(), 1);
+
+    // The answer is a move of ours once the line is played
+    std::istringstream words(bestmove[0]);
+    std::string word, move;
+    words >> word >> move;
+    EXPECT_NE(move, "0000");
+
+    engine.dispatch("position classic moves " + line + " " + move);
+    EXPECT_EQ(capture.take(), "");
+    EXPECT_EQ(engine.exitStatus(), 0);
+}
+
+TEST(TestEngine, PonderOffTheExpectedLineWaitsForPonderHit)
+{
+    CaptureOutput capture;
+    Engine engine;
+
+    // A depth 3 line ends on the third player, short of our next turn
+    engine.dispatch("position classic");
+    engine.dispatch("go depth 3");
+    engine.dispatch("position classic");
+    auto pv = lastPv(capture.take());
+    ASSERT_EQ(pv.size(), 3);
+
+    // Nothing is searched until ponderhit makes the given position real
+    auto setup = "position classic moves " + pv[0] + " " + pv[1];
+    engine.dispatch(setup);
+    engine.dispatch("go ponder depth 2");
+    EXPECT_EQ(capture.take(), "");
+    engine.dispatch("ponderhit");
+    engine.dispatch("position classic");
+
+    auto text = capture.take();
+    EXPECT_EQ(linesStarting(text, "info depth 2 ").size(), 1);
+    auto bestmove = linesStarting(text, "bestmove");
+    ASSERT_EQ(bestmove.size(), 1);
+
+    std::istringstream words(bestmove[0]);
+    std::string word, move;
+    words >> word >> move;
+    engine.dispatch(setup + " " + move);
+    EXPECT_EQ(capture.take(), "");
+    EXPECT_EQ(engine.exitStatus(), 0);
+}
+
+TEST(TestEngine, StopAnswersAPonderThatNeverStarted)
+{
+    CaptureOutput capture;
+    Engine engine;
+
+    // Before the first search there is no expected line at all
+    engine.dispatch("position classic moves i3i4");
+    engine.dispatch("go ponder");
+    engine.dispatch("stop");
+
+    auto bestmove = linesStarting(capture.take(), "bestmove");
+    ASSERT_EQ(bestmove.size(), 1);
+
+    std::istringstream words(bestmove[0]);
+    std::string word, move;
+    words >> word >> move;
+    EXPECT_NE(move, "0000");
+    engine.dispatch("position classic moves i3i4 " + move);
+    EXPECT_EQ(capture.take(), "");
+
+    // Stopped once, nothing is left to answer
+    engine.dispatch("stop");
+    EXPECT_EQ(capture.take(), "");
+}
+
+TEST(TestEngine, ClockLimitsTheSearch)
+{
+    CaptureOutput capture;
+    Engine engine;
+
+    // A few milliseconds on Red's clock end an otherwise unbounded search
+    engine.dispatch("position classic");
+    engine.dispatch("go wtime 90 btime 600000 winc 0 binc 0");
+    engine.dispatch("position classic");
+    EXPECT_EQ(linesStarting(capture.take(), "bestmove").size(), 1);
+
+    // The clock starts at ponderhit
+    engine.dispatch("position classic moves i3i4");
+    engine.dispatch("go ponder btime 90 wtime 600000");
+    engine.dispatch("ponderhit");
+    engine.dispatch("position classic");
+    EXPECT_EQ(linesStarting(capture.take(), "bestmove").size(), 1);
+    EXPECT_EQ(engine.exitStatus(), 0);
+
+    engine.dispatch("go wtime -1");
+    EXPECT_EQ(capture.take(), "info string invalid go limits\n");
+}
+
+TEST(TestEngine, StopEndsAnInfiniteSearch)
+{
+    CaptureOutput capture;
+    Engine engine;
+
+    engine.dispatch("position classic");
+    engine.dispatch("go infinite");
+    engine.dispatch("ponderhit"); // not pondering, ignored
+    engine.dispatch("stop");
+
+    auto text = capture.take();
+    auto bestmove = linesStarting(text, "bestmove");
+    ASSERT_EQ(bestmove.size(), 1);
+    EXPECT_EQ(text.substr(text.size() - bestmove[0].size() - 1), bestmove[0] + "\n");
+    EXPECT_NE(bestmove[0], "bestmove 0000");
+
+    // Nothing is left running to print later
+    engine.dispatch("position classic");
+    EXPECT_EQ(capture.take(), "");
+}
+
+TEST(TestEngine, DispatchMatchesCommandsExactly)
+{
+    CaptureOutput capture;
+    Engine engine;
+
+    EXPECT_TRUE(engine.dispatch("isready"));
+    EXPECT_TRUE(engine.dispatch("  isready  "));
+    EXPECT_EQ(capture.take(), "readyok\nreadyok\n");
+
+    // Command names are case-sensitive, the rest goes to the CLI
+    EXPECT_FALSE(engine.dispatch("IsReady"));
+    EXPECT_FALSE(engine.dispatch("perft 1"));
+    EXPECT_FALSE(engine.dispatch("isreadyok"));
+    EXPECT_EQ(capture.take(), "");
+}
+
+TEST(TestEngine, LaunchStripsCarriageReturns)
+{
+    CaptureOutput capture;
+    std::istringstream input("uci\r\n\r\nisready\r\nposition classic moves e3e6\r\n");
+    auto* saved = std::cin.rdbuf(input.rdbuf());
+
+    Engine engine;
+    engine.launch();
+    std::cin.rdbuf(saved);
+
+    auto text = capture.take();
+    EXPECT_TRUE(text.ends_with("uciok\nreadyok\ninfo string invalid move: e3e6\n")) << text;
+    EXPECT_EQ(text.find('\r'), std::string::npos);
+}
+
+TEST(TestEngine, SetOptionParsesNamesAndValues)
+{
+    CaptureOutput capture;
+    Engine engine;
+    engine.dispatch("position classic");
+
+    // Names match without case, values run to the end of the line
+    engine.dispatch("setoption name multipv value   2  ");
+    engine.dispatch("setoption name PONDER value true");
+    engine.dispatch("go depth 1");
+    engine.dispatch("position classic");
+    EXPECT_EQ(linesStarting(capture.take(), "info depth 1 multipv ").size(), 2);
+    EXPECT_EQ(engine.exitStatus(), 0);
+
+    // Names with spaces are kept whole, as are values
+    engine.dispatch("setoption name Multi PV value 3");
+    EXPECT_EQ(capture.take(), "info string unknown option name: Multi PV\n");
+    engine.dispatch("setoption name EvalFile value /no such dir/net file.nnue");
+    EXPECT_EQ(capture.take(), "info string cannot load network file: /no such dir/net file.nnue\n");
+    engine.dispatch("setoption name MultiPV value 2 3");
+    EXPECT_EQ(capture.take(), "info string invalid number: 2 3\n");
+    engine.dispatch("setoption MultiPV value 2");
+    EXPECT_EQ(capture.take(), "info string expected format: setoption name <name> value <value>\n");
+    EXPECT_EQ(engine.exitStatus(), 1);
+}
+
+TEST(TestEngine, PositionRejectsUnknownMoves)
+{
+    CaptureOutput capture;
+    Engine engine;
+
+    // Well-formed, but not a legal move
+    engine.dispatch("position classic moves e3e6");
+    EXPECT_EQ(capture.take(), "info string invalid move: e3e6\n");
+    EXPECT_EQ(engine.exitStatus(), 1);
+
+    engine.dispatch("position classic moves e3e4q");
+    EXPECT_EQ(capture.take(), "info string invalid move: e3e4q\n");
+    engine.dispatch("position classic move e3e4");
+    EXPECT_EQ(capture.take(), "info string expected 'moves' keyword\n");
+}
+
+TEST(TestEngine, ScoreNeedsANetwork)
+{
+    CaptureOutput capture;
+    std::istringstream input("score positions.txt\n");
+    auto* saved = std::cin.rdbuf(input.rdbuf());
+
+    Engine engine;
+    engine.launch();
+    std::cin.rdbuf(saved);
+
+    EXPECT_EQ(capture.take(), "info string no network loaded, set EvalFile first\n");
+    EXPECT_EQ(engine.exitStatus(), 1);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <random>
+#include "eval.h"
+#include "movegen.h"
+#include "utility.h"
+#include "nnue/nnue.h"
+
+using namespace athena;
+
+TEST(TestEval, IncrementalMaterial)
+{
+    Position pos;
+    fromString("modern R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bk,bp,10,gp,gq,bq,bp,10,gp,gk,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr", pos);
+
+    std::mt19937 rng(11);
+    std::vector<Move> line;
+
+    for (int step = 0; step < 300; ++step)
+    {
+        Move moves[MAX_MOVES];
+        int size = 0;
+        size += genAllNoisyMoves(pos, moves + size);
+        size += genAllQuietMoves(pos, moves + size);
+
+        // Prefer captures so material actually changes
+        Move move = (size > 0 && moves[0].flag() == Noisy) ? moves[0] : moves[rng() % std::max(size, 1)];
+        if (size == 0 || step % 5 == 4)
+        {
+            if (line.empty()) continue;
+            pos.undomove(line.back());
+            line.pop_back();
+        }
+        else
+        {
+            pos.makemove(move);
+            line.push_back(move);
+        }
+
+        for (auto color : COLORS)
+        {
+            int expected = 0;
+            for (auto sq : pos.board.occ(color))
+                expected += PIECE_VALUE[pos.board[sq].piece()];
+            ASSERT_EQ(pos.board.value(color), expected) << "step " << step;
+        }
+    }
+}
+
+TEST(TestEval, HybridSkipsLopsidedPositions)
+{
+    // A zero network: header and zeroed parameters
+    std::string path = ::testing::TempDir() + "athena_zero.nnue";
+    {
+        std::ofstream file(path, std::ios::binary);
+        uint32_t header[3] = {NetworkMagic, NetworkVersion, DefaultArch::Id};
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        std::vector<char> zeros(sizeof(int32_t) * Model<DefaultArch>::Parameters, 0);
+        file.write(zeros.data(), zeros.size());
+    }
+
+    NNUE nnue;
+    ASSERT_TRUE(nnue.load(path));
+
+    Thread thread;
+    thread.nnue = &nnue;
+
+    // Red has three queens, everyone else has nothing
+    Position pos;
+    fromString("classic r 0 0000 0000 -,-,-,- rq,rq,rq,rk,156", pos);
+    nnue.reset();
+    ASSERT_EQ(material(pos), 2700);
+
+    // The skip returns the classical score, mobility included
+    EXPECT_EQ(evaluate(pos, thread, -100, 100), evaluate(pos));
+    EXPECT_GT(evaluate(pos), material(pos));
+    EXPECT_EQ(thread.evals, 1);
+    EXPECT_EQ(thread.skips, 1);
+
+    // A window around the material score needs the network
+    EXPECT_EQ(evaluate(pos, thread, 2000, 3000), 0);
+    EXPECT_EQ(thread.evals, 2);
+    EXPECT_EQ(thread.skips, 1);
+}
@@ -2,6 +2,7 @@
 #include "position.h"
 #include "movegen.h"
 #include "utility.h"
+#include <random>
 
 using namespace athena;
 
@@ -135,8 +136,158 @@ TEST_F(TestMoveGen, GenCastleMoves)
     checkMoves(size, {});
 }
 
+TEST_F(TestMoveGen, CastleRightsUpdate)
+{
+    // Red king and both rooks at home, red to move
+    fromString("classic r 0 1000 1000 -,-,-,- rr,3,rk,2,rr,152", pos);
+    ASSERT_EQ(pos.states.back().castle, castleBit(Red, KingSide) | castleBit(Red, QueenSide));
+
+    // Moving the king-side rook keeps only the queen-side right
+    pos.makemove(Move(L2, L3, Slider, Quiet));
+    EXPECT_EQ(pos.states.back().castle, castleBit(Red, QueenSide));
+    EXPECT_EQ(toString(pos.states.back().castle, KingSide), "0000");
+    EXPECT_EQ(toString(pos.states.back().castle, QueenSide), "1000");
+    pos.undomove(Move(L2, L3, Slider, Quiet));
+
+    // Moving the king drops both
+    pos.makemove(Move(I2, I3, Jumper, Quiet));
+    EXPECT_EQ(pos.states.back().castle, 0);
+}
+
+TEST_F(TestMoveGen, IsLegalMatchesMakeMove)
+{
+    std::mt19937 rng(17);
+
+    for (int game = 0; game < 20; ++game)
+    {
+        fromString("classic R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bq,bp,10,gp,gk,bk,bp,10,gp,gq,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr", pos);
+
+        for (int ply = 0; ply < 120; ++ply)
+        {
+            Color turn = pos.states.back().turn;
+
+            size = 0;
+            size += genAllNoisyMoves(pos, moves + size);
+            size += genAllQuietMoves(pos, moves + size);
+
+            std::vector<Move> legal;
+            for (int i = 0; i < size; ++i)
+            {
+                pos.makemove(moves[i]);
+                bool expected = isRoyalSafe(pos, turn);
+                pos.undomove(moves[i]);
+
+                ASSERT_EQ(isLegal(pos, moves[i]), expected) << toString(pos) << " " << toString(moves[i]);
+                if (expected) legal.push_back(moves[i]);
+            }
+
+            if (legal.empty()) break;
+
+            // Prefer captures so games open up and kings get exposed
+            Move move = legal[rng() % legal.size()];
+            for (auto m : legal)
+                if (m.flag() == Noisy && rng() % 2) { move = m; break; }
+            pos.makemove(move);
+        }
+    }
+}
+
+TEST_F(TestMoveGen, CopyMakeRestoresBoard)
+{
+    std::mt19937 rng(29);
+
+    for (int game = 0; game < 20; ++game)
+    {
+        CopyMake walk;
+        fromString("modern R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bk,bp,10,gp,gq,bq,bp,10,gp,gk,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr", pos);
+
+        for (int ply = 0; ply < 150; ++ply)
+        {
+            size = 0;
+            size += genAllNoisyMoves(pos, moves + size);
+            size += genAllQuietMoves(pos, moves + size);
+            if (size == 0) break;
+
+            std::string before = toString(pos);
+            auto depth = pos.states.size();
+
+            for (int i = 0; i < size; ++i)
+            {
+                walk.make(pos, moves[i]);
+                walk.undo(pos, moves[i]);
+
+                ASSERT_EQ(toString(pos), before) << toString(moves[i]);
+                ASSERT_EQ(pos.states.size(), depth);
+
+                Position reference = pos;
+                reference.makemove(moves[i]);
+                reference.undomove(moves[i]);
+                for (auto piece : {Pawn, Knight, Bishop, Rook, Queen, King})
+                    ASSERT_EQ(pos.board.occ(piece), reference.board.occ(piece)) << toString(moves[i]);
+                for (auto color : {Red, Blue, Yellow, Green})
+                {
+                    ASSERT_EQ(pos.board.occ(color), reference.board.occ(color)) << toString(moves[i]);
+                    ASSERT_EQ(pos.board.value(color), reference.board.value(color)) << toString(moves[i]);
+                }
+            }
+
+            // Prefer captures so promotions and en passant come up
+            Move move = moves[rng() % size];
+            for (int i = 0; i < size; ++i)
+                if (moves[i].flag() == Noisy && rng() % 2) { move = moves[i]; break; }
+            walk.make(pos, move);
+        }
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
+
+TEST_F(TestMoveGen, EliminatedPiecesOnlyBlock)
+{
+    // Blue's queen gives check while Blue is in the game
+    fromString("classic r 0 0000 0000 -,-,-,- rk,bq,158", pos);
+    EXPECT_FALSE(isRoyalSafe(pos, Red));
+    checkMoves(genAllNoisyMoves(pos, moves), {"e2f2"});
+
+    // Once Blue is out it can neither give check nor be taken
+    fromString("classic r 0 0000 0000 -,-,-,- rk,bq,158 1011", pos);
+    EXPECT_TRUE(isRoyalSafe(pos, Red));
+    EXPECT_EQ(genAllNoisyMoves(pos, moves), 0);
+
+    // but it still blocks
+    fromString("classic r 0 0000 0000 -,-,-,- rr,bq,rk,157 1011", pos);
+    size = genAllQuietMoves(pos, moves);
+    for (int i = 0; i < size; ++i)
+        EXPECT_NE(moves[i].target(), G2) << toString(moves[i]);
+}
+
+TEST_F(TestMoveGen, CastleUndoRestoresTheRook)
+{
+    // Undo runs with the next player to move, the rook is still Red's
+    fromString("classic r 0 1000 1000 -,-,-,- rr,3,rk,2,rr,152", pos);
+    std::string before = toString(pos);
+
+    size = genAllQuietMoves(pos, moves);
+    for (int i = 0; i < size; ++i)
+    {
+        if (moves[i].nature() != Castle) continue;
+        pos.makemove(moves[i]);
+        pos.undomove(moves[i]);
+        EXPECT_EQ(toString(pos), before) << toString(moves[i]);
+    }
+}
+
+TEST_F(TestMoveGen, EnpassNeedsThePushedPawn)
+{
+    // Blue's pawn pushed past d5 to e5 has since been taken, Green's is
+    // still there
+    fromString("classic r 0 0000 0000 -,d5,-,m5 16,rp,6,rp,10,gp,125", pos);
+    size = 0;
+    size += genAllNoisyMoves(pos, moves + size);
+    size += genAllQuietMoves(pos, moves + size);
+    checkMoves(size, {"l4m5", "e4e5"});
+}
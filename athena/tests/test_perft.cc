@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include "perft.h"
+#include "utility.h"
+#include <sstream>
+
+using namespace athena;
+
+class TestPerft : public ::testing::Test
+{
+protected:
+    Position pos;
+
+    void SetUp() override
+    {
+        fromString("modern R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bk,bp,10,gp,gq,bq,bp,10,gp,gk,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr", pos);
+    }
+};
+
+TEST_F(TestPerft, KnownCounts)
+{
+    EXPECT_EQ(perft(pos, 1, false).nodes, 20);
+    EXPECT_EQ(perft(pos, 2, false).nodes, 395);
+    EXPECT_EQ(perft(pos, 3, false).nodes, 7800);
+}
+
+TEST_F(TestPerft, ThreadedMatchesSerial)
+{
+    for (int depth = 1; depth <= 4; ++depth)
+    {
+        Record serial = perft(pos, depth, true, 1);
+        Record threaded = perft(pos, depth, true, 4);
+
+        EXPECT_EQ(threaded.nodes, serial.nodes) << "depth " << depth;
+        EXPECT_EQ(threaded.noisy, serial.noisy) << "depth " << depth;
+        EXPECT_EQ(threaded.quiet, serial.quiet) << "depth " << depth;
+        EXPECT_EQ(threaded.castle, serial.castle) << "depth " << depth;
+        EXPECT_EQ(threaded.checkmates, serial.checkmates) << "depth " << depth;
+        EXPECT_EQ(threaded.stalemates, serial.stalemates) << "depth " << depth;
+    }
+}
+
+TEST_F(TestPerft, CopyMakeMatchesMakeUnmake)
+{
+    for (int depth = 1; depth <= 3; ++depth)
+    {
+        Record unmake = perft(pos, depth, true);
+        Record copy = perft<CopyMake>(pos, depth, true);
+        Record threaded = perft<CopyMake>(pos, depth, true, 3);
+
+        EXPECT_EQ(copy.nodes, unmake.nodes) << "depth " << depth;
+        EXPECT_EQ(copy.evolve, unmake.evolve) << "depth " << depth;
+        EXPECT_EQ(copy.checkmates, unmake.checkmates) << "depth " << depth;
+        EXPECT_EQ(threaded.nodes, unmake.nodes) << "depth " << depth;
+    }
+}
+
+TEST_F(TestPerft, DivideSumsToTotal)
+{
+    auto moves = divide(pos, 3, false, 3);
+    ASSERT_EQ(moves.size(), 20);
+
+    uint64_t total = 0;
+    for (const auto &[move, rc] : moves)
+        total += rc.nodes;
+    EXPECT_EQ(total, 7800);
+}
+
+TEST_F(TestPerft, HashedMatchesUnhashed)
+{
+    for (bool full : {false, true})
+    {
+        PerftTable table(4, full);
+        for (int depth = 1; depth <= 4; ++depth)
+        {
+            Record plain = perft(pos, depth, full);
+            Record hashed = perft(pos, depth, full, 1, &table);
+            Record shared = perft(pos, depth, full, 3, &table);
+
+            EXPECT_EQ(hashed.nodes, plain.nodes) << "depth " << depth;
+            EXPECT_EQ(shared.nodes, plain.nodes) << "depth " << depth;
+            EXPECT_EQ(hashed.jumper, plain.jumper) << "depth " << depth;
+            EXPECT_EQ(shared.checkmates, plain.checkmates) << "depth " << depth;
+        }
+    }
+}
+
+TEST(TestPerftSuite, ReportsMismatches)
+{
+    std::string fen = "modern R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bk,bp,10,gp,gq,bq,bp,10,gp,gk,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr";
+
+    std::stringstream good("# comment\n\n" + fen + " ;D1 20 ;D2 395\n");
+    std::stringstream json;
+    EXPECT_EQ(runPerftSuite(good, json, 2), 0);
+    EXPECT_NE(json.str().find("\"failed\": 0"), std::string::npos);
+
+    std::stringstream bad(fen + " ;D1 20 ;D2 396\n" + fen + " ;D3 7801\n");
+    std::stringstream csv;
+    EXPECT_EQ(runPerftSuite(bad, csv, 1, true), 2);
+    EXPECT_NE(csv.str().find("1,2,395,396,"), std::string::npos);
+
+    std::stringstream broken(fen + " ;X1 20\n");
+    std::stringstream sink;
+    EXPECT_THROW(runPerftSuite(broken, sink), std::invalid_argument);
+
+    // The alive players field is optional
+    std::stringstream alive("classic y 0 0000 0000 -,-,-,- rk,158,yk 1010 ;D1 3\n");
+    EXPECT_EQ(runPerftSuite(alive, sink), 0);
+
+    // A bad board is reported before any worker thread starts
+    std::stringstream board(fen + " ;D1 20\nclassic r 0 1111 1111 -,-,-,- zz,159 ;D1 1\n");
+    EXPECT_THROW(runPerftSuite(board, sink, 2), std::invalid_argument);
+
+    // So is a depth the state stack cannot hold
+    std::stringstream deep(fen + " ;D1 20 ;D" + std::to_string(MAX_PLY) + " 0\n");
+    EXPECT_THROW(runPerftSuite(deep, sink, 2), std::invalid_argument);
+}
+
+TEST_F(TestPerft, DepthMustFitTheStateStack)
+{
+    // A long game leaves room for two more plies
+    while (pos.states.size() < MAX_PLY - 2)
+        pos.states.emplace_back(pos.states.back());
+
+    EXPECT_EQ(perft(pos, 2, false).nodes, 395);
+    EXPECT_EQ(perft<CopyMake>(pos, 2, false, 2).nodes, 395);
+    EXPECT_THROW(perft(pos, 3, false), std::invalid_argument);
+    EXPECT_THROW(divide(pos, 3, false, 2), std::invalid_argument);
+    EXPECT_EQ(pos.states.size(), MAX_PLY - 2);
+}
+
+TEST_F(TestPerft, DivideAgainstFindsFailingNode)
+{
+    // Reference trace three levels deep, with one extra move planted below
+    // the first root move and its first reply
+    auto root = divide(pos, 3, false);
+    Move a = root[0].first;
+
+    pos.makemove(a);
+    auto second = divide(pos, 2, false);
+    Move b = second[0].first;
+
+    pos.makemove(b);
+    auto third = divide(pos, 1, false);
+    std::string fen = toString(pos);
+    pos.undomove(b);
+    pos.undomove(a);
+
+    std::string pa = toString(a), pb = toString(b);
+    std::stringstream trace;
+    for (auto &[move, rc] : root)
+        trace << toString(move) << ": " << rc.nodes + (toString(move) == pa) << "\n";
+    for (auto &[move, rc] : second)
+        trace << pa << " " << toString(move) << ": " << rc.nodes + (toString(move) == pb) << "\n";
+    for (auto &[move, rc] : third)
+        trace << pa << " " << pb << " " << toString(move) << ": " << rc.nodes << "\n";
+    trace << pa << " " << pb << " a1a1: 1\n";
+    std::string reference = trace.str();
+
+    std::stringstream out;
+    EXPECT_EQ(divideAgainst(pos, 3, trace, out, 2), 1);
+    EXPECT_NE(out.str().find("fen " + fen), std::string::npos) << out.str();
+    EXPECT_NE(out.str().find("path " + pa + " " + pb), std::string::npos) << out.str();
+    EXPECT_NE(out.str().find("move a1a1"), std::string::npos) << out.str();
+
+    // The position is left as it was
+    EXPECT_EQ(pos.states.size(), 1);
+
+    // A matching trace reports no mismatch
+    std::stringstream clean;
+    for (auto &[move, rc] : root)
+        clean << toString(move) << ": " << rc.nodes << "\n";
+    std::stringstream sink;
+    EXPECT_EQ(divideAgainst(pos, 3, clean, sink), 0);
+}
+
+TEST_F(TestPerft, FenRoundTrip)
+{
+    Position copy;
+    fromString(toString(pos), copy);
+    EXPECT_EQ(toString(copy), toString(pos));
+    EXPECT_EQ(copy.states.back().hash, pos.states.back().hash);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "position.h"
+#include "search.h"
+#include "utility.h"
+
+using namespace athena;
+
+constexpr const char* FEN_CLASSIC = "classic r 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bq,bp,10,gp,gk,bk,bp,10,gp,gq,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr";
+
+TEST(TestStateStack, CopiesOnlyUsedPlies)
+{
+    StateStack states;
+    EXPECT_TRUE(states.empty());
+
+    ndarray<Square, COLOR_NB - 1> enpass;
+    enpass.fill(OFFBOARD);
+    for (int clock = 0; clock < 5; ++clock)
+        states.emplace_back(clock, Red, clock * 7, 0, ALL_ALIVE, EMPTY, enpass);
+
+    StateStack copy = states;
+    ASSERT_EQ(copy.size(), 5);
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ(copy[i].clock, i);
+        EXPECT_EQ(copy[i].hash, i * 7);
+    }
+
+    copy.pop_back();
+    states = copy;
+    EXPECT_EQ(states.size(), 4);
+    EXPECT_EQ(states.back().clock, 3);
+}
+
+TEST(TestStateStack, SearchStopsAtCapacity)
+{
+    Position pos;
+    fromString(FEN_CLASSIC, pos);
+
+    // A history that leaves room for only a couple of plies
+    while (pos.states.size() < MAX_PLY - 2)
+        pos.states.emplace_back(pos.states.back());
+    EXPECT_FALSE(pos.states.full());
+
+    Thread thread;
+    negamax(pos, thread, -SCORE_INFINITY, SCORE_INFINITY, 4, 0);
+    EXPECT_EQ(pos.states.size(), MAX_PLY - 2);
+    EXPECT_GT(thread.nodes, 0);
+
+    while (!pos.states.full())
+        pos.states.emplace_back(pos.states.back());
+    EXPECT_EQ(pos.states.size(), MAX_PLY);
+}
@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "search.h"
+#include "eval.h"
+#include "movegen.h"
+#include "utility.h"
+
+using namespace athena;
+
+constexpr const char* FEN_CLASSIC = "classic r 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bq,bp,10,gp,gk,bk,bp,10,gp,gq,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr";
+
+// Minimax over the same tree with every child searched on the full window,
+// leaves scored by the same quiescence search
+static int minimax(Position& pos, Thread& thread, int depth, std::uint64_t& nodes)
+{
+    ++nodes;
+    if (depth == 0)
+        return negamax(pos, thread, -SCORE_INFINITY, SCORE_INFINITY, 0, 1);
+
+    Move moves[MAX_MOVES];
+    int size = 0;
+    size += genAllNoisyMoves(pos, moves + size);
+    size += genAllQuietMoves(pos, moves + size);
+
+    int best = -SCORE_INFINITY;
+    for (int i = 0; i < size; ++i)
+    {
+        if (!isLegal(pos, moves[i])) continue;
+        pos.makemove(moves[i]);
+        best = std::max(best, -minimax(pos, thread, depth - 1, nodes));
+        pos.undomove(moves[i]);
+    }
+    return best;
+}
+
+// Plays moves given in coordinate notation, e.g. "i3i4 c8d8"
+static void play(Position& pos, const std::string& line)
+{
+    std::istringstream words(line);
+    for (std::string word; words >> word; )
+    {
+        Move moves[MAX_MOVES];
+        int size = 0;
+        size += genAllNoisyMoves(pos, moves + size);
+        size += genAllQuietMoves(pos, moves + size);
+
+        auto found = std::find_if(moves, moves + size, [&](Move m) { return toString(m) == word; });
+        ASSERT_NE(found, moves + size) << word;
+        pos.makemove(*found);
+    }
+}
+
+TEST(TestSearch, IteratesToDepthWithPv)
+{
+    Position pos;
+    fromString(FEN_CLASSIC, pos);
+    auto fen = toString(pos);
+
+    Thread thread;
+    SearchControl control;
+    control.depth = 3;
+
+    std::ostringstream output;
+    search(pos, thread, control, output);
+
+    EXPECT_EQ(control.completed, 3);
+    EXPECT_EQ(toString(pos), fen);
+    for (int depth = 1; depth <= 3; ++depth)
+        EXPECT_NE(output.str().find("info depth " + std::to_string(depth) + " "), std::string::npos) << depth;
+
+    // The line starts with the move played and every move in it is legal
+    ASSERT_GE(thread.pv.size(), 2);
+    EXPECT_EQ(toString(thread.pv[0]), toString(thread.move));
+    for (Move m : thread.pv)
+    {
+        EXPECT_TRUE(isLegal(pos, m)) << toString(m);
+        pos.makemove(m);
+    }
+}
+
+TEST(TestSearch, StoppedSearchKeepsAMove)
+{
+    Position pos;
+    fromString(FEN_CLASSIC, pos);
+
+    Thread thread;
+    SearchControl control;
+    control.depth = MAX_PV;
+    control.deadline = 1; // long gone
+
+    std::ostringstream output;
+    search(pos, thread, control, output);
+
+    // The clock is read every 1024 nodes, so a few shallow iterations finish
+    EXPECT_TRUE(control.stop);
+    EXPECT_GE(control.completed, 1);
+    EXPECT_LT(control.completed, MAX_PV);
+
+    Move moves[MAX_MOVES];
+    int size = genAllQuietMoves(pos, moves);
+    EXPECT_NE(std::find_if(moves, moves + size, [&](Move m) { return toString(m) == toString(thread.move); }), moves + size);
+}
+
+TEST(TestSearch, MultiPvReportsDistinctLinesBestFirst)
+{
+    Position pos;
+    fromString(FEN_CLASSIC, pos);
+
+    Thread single;
+    SearchControl one;
+    one.depth = 2;
+    std::ostringstream ignored;
+    search(pos, single, one, ignored);
+
+    Thread thread;
+    SearchControl control;
+    control.depth = 2;
+    control.multipv = 3;
+    std::ostringstream output;
+    search(pos, thread, control, output);
+
+    EXPECT_EQ(thread.score, single.score);
+
+    // The last three lines are depth 2, multipv 1 to 3
+    std::vector<std::string> lines;
+    std::istringstream input(output.str());
+    for (std::string line; std::getline(input, line); ) lines.push_back(line);
+    ASSERT_EQ(lines.size(), 6);
+
+    std::vector<std::string> moves;
+    int previous = SCORE_INFINITY;
+    for (int k = 0; k < 3; ++k)
+    {
+        std::istringstream line(lines[3 + k]);
+        std::string word, depth, multipv, cp, pv;
+        int score;
+        line >> word >> word >> depth >> word >> multipv >> word >> cp >> score;
+        while (line >> word && word != "pv") {}
+        line >> pv;
+
+        EXPECT_EQ(depth, "2");
+        EXPECT_EQ(multipv, std::to_string(k + 1));
+        EXPECT_LE(score, previous);
+        previous = score;
+
+        EXPECT_EQ(std::find(moves.begin(), moves.end(), pv), moves.end()) << pv;
+        moves.push_back(pv);
+    }
+
+    EXPECT_EQ(moves[0], toString(thread.move));
+}
+
+TEST(TestSearch, RaisedAlphaPrunesLaterSiblings)
+{
+    Position pos;
+    fromString(FEN_CLASSIC, pos);
+
+    Thread reference;
+    std::uint64_t nodes = 0;
+    int expected = minimax(pos, reference, 3, nodes);
+
+    // Same score, but once a move raises alpha its siblings are refuted
+    // early instead of being searched on the full window
+    Thread thread;
+    EXPECT_EQ(negamax(pos, thread, -SCORE_INFINITY, SCORE_INFINITY, 3, 0), expected);
+    EXPECT_LT(thread.nodes, nodes / 2);
+}
+
+TEST(TestSearch, QuiescenceUndoesCapturesAndCutsAtBeta)
+{
+    // Blue to move with a capture worth far more than standing pat
+    Position pos;
+    fromString(FEN_CLASSIC, pos);
+    play(pos, "i3i4 c8d8 f15g13 n5m5 j2e7");
+    auto fen = toString(pos);
+    auto plies = pos.states.size();
+
+    Thread thread;
+    int standPat = evaluate(pos);
+    int score = negamax(pos, thread, -SCORE_INFINITY, SCORE_INFINITY, 0, 0);
+    ASSERT_GT(score, standPat + 1);
+    EXPECT_EQ(toString(pos), fen);
+    EXPECT_EQ(pos.states.size(), plies);
+
+    // A capture that clears beta fails high at beta instead of past it
+    int beta = (standPat + score) / 2;
+    EXPECT_EQ(negamax(pos, thread, standPat, beta, 0, 0), beta);
+    EXPECT_EQ(toString(pos), fen);
+    EXPECT_EQ(pos.states.size(), plies);
+}
+
+TEST(TestSearch, RootSearchesOnlyLegalMoves)
+{
+    // Red is in check from Blue's rook, which Green's rook defends. Taking
+    // it wins material unless Green's turn comes, but only e2e3 is legal.
+    Position pos;
+    fromString("classic r 0 0000 0000 -,-,-,- rk,br,26,gr,37,bk,12,gk,79,yk", pos);
+
+    Thread thread;
+    SearchControl control;
+    control.depth = 2;
+    control.multipv = 3;
+    std::ostringstream output;
+    search(pos, thread, control, output);
+
+    std::vector<std::string> moves;
+    std::istringstream input(output.str());
+    for (std::string line; std::getline(input, line); )
+        if (line.starts_with("info depth 2 "))
+            moves.push_back(line.substr(line.find(" pv ") + 4, 4));
+
+    EXPECT_EQ(moves, std::vector<std::string>{"e2e3"});
+    EXPECT_EQ(toString(thread.move), "e2e3");
+}
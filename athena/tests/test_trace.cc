@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+#include "trace.h"
+
+using namespace athena;
+
+TEST(TestTrace, RingKeepsOrderAndDropsWhenFull)
+{
+    TraceRing ring(4);
+
+    for (uint64_t node = 0; node < 6; ++node)
+        ring.push({node, 0, 0, 0, Move(), 0, 0, TraceAll});
+
+    std::vector<uint64_t> nodes;
+    EXPECT_EQ(ring.drain([&](const TraceRecord& r) { nodes.push_back(r.node); }), 4);
+    EXPECT_EQ(nodes, (std::vector<uint64_t>{0, 1, 2, 3}));
+    EXPECT_EQ(ring.droppedCount(), 2);
+
+    // Drained slots are free again
+    ring.push({6, 0, 0, 0, Move(), 0, 0, TraceAll});
+    EXPECT_EQ(ring.drain([](const TraceRecord&) {}), 1);
+}
+
+TEST(TestTrace, SamplesByNodeAndPly)
+{
+    TraceRing ring(4);
+    ring.sample = 3;
+    ring.maxPly = 2;
+
+    EXPECT_TRUE(ring.wants(0, 0));
+    EXPECT_FALSE(ring.wants(1, 0));
+    EXPECT_TRUE(ring.wants(6, 2));
+    EXPECT_FALSE(ring.wants(6, 3));
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "utility.h"
+
+using namespace athena;
+
+constexpr const char* FEN_START = "classic r 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bq,bp,10,gp,gk,bk,bp,10,gp,gq,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr";
+
+TEST(TestFen, RoundTrip)
+{
+    for (const char* fen : {
+        FEN_START,
+        "modern g 17 1101 0100 k4,d9,-,m8 rr,1,rb,rq,rk,2,rr,1,rp,rp,rp,3,rp,2,rn,1,rp,rp,1,rn,br,1,bp,rp,5,rp,2,gp,gr,bn,bp,10,gp,gn,2,bp,rb,8,gp,gb,bk,2,bp,8,gp,gq,3,bp,7,gp,gb,gk,2,bp,7,gp,3,bn,11,gp,1,br,1,bb,4,yn,1,yp,gp,2,gr,2,yp,6,yp,2,yk,yp,4,yb,1,yq,1,yn,yr",
+        "classic b 0 0000 0000 -,-,-,- rk,158,yk",
+        "classic y 0 0000 0000 -,-,-,- rk,158,yk 1010" })
+    {
+        Position pos;
+        fromString(fen, pos);
+        EXPECT_EQ(toString(pos), fen);
+
+        char buffer[MAX_FEN_LENGTH];
+        EXPECT_EQ(std::string(buffer, toString(pos, buffer)), fen);
+    }
+}
+
+TEST(TestFen, ToleratesExtraSpacesAndShortBoards)
+{
+    Position pos;
+    fromString("  classic   R 0 0000 0000 -,-,-,-   rk,3,yk  ", pos);
+    EXPECT_EQ(toString(pos), "classic r 0 0000 0000 -,-,-,- rk,3,yk,155");
+}
+
+TEST(TestFen, RejectsMalformed)
+{
+    for (const char* fen : {
+        "",
+        "classic r 0 1111 1111 -,-,-,-",
+        "chess r 0 1111 1111 -,-,-,- rk,159",
+        "classic x 0 1111 1111 -,-,-,- rk,159",
+        "classic r zero 1111 1111 -,-,-,- rk,159",
+        "classic r 0 111 1111 -,-,-,- rk,159",
+        "classic r 0 1111 1111 -,-,- rk,159",
+        "classic r 0 1111 1111 a1,-,-,- rk,159",
+        "classic r 0 1111 1111 -,-,-,- rz,159",
+        "classic r 0 1111 1111 -,-,-,- rk,160",
+        "classic r 0 1111 1111 -,-,-,- rk,159 101",
+        "classic r 0 1111 1111 -,-,-,- rk,159 0000",
+        "classic r 0 1111 1111 -,-,-,- rk,159 0111" })
+    {
+        Position pos;
+        fromString(FEN_START, pos);
+
+        EXPECT_THROW(fromString(fen, pos), std::invalid_argument) << fen;
+
+        // A failed parse leaves the position alone
+        EXPECT_EQ(toString(pos), FEN_START);
+        EXPECT_EQ(pos.states.size(), 1);
+    }
+}
+
+TEST(TestMoveText, ParsesSquaresAndPromotion)
+{
+    Square source, target;
+    Piece evolve;
+
+    fromString("e3e4", source, target, evolve);
+    EXPECT_EQ(source, E3);
+    EXPECT_EQ(target, E4);
+    EXPECT_EQ(evolve, Empty);
+
+    fromString("k13k14q", source, target, evolve);
+    EXPECT_EQ(source, K13);
+    EXPECT_EQ(target, K14);
+    EXPECT_EQ(evolve, Queen);
+
+    for (const char* text : {"", "e3", "e3e", "e3e4k", "e3e4qq", "z3e4", "e3e44"})
+        EXPECT_THROW(fromString(text, source, target, evolve), std::invalid_argument) << text;
+}
+
+TEST(TestTokens, SplitsOnRunsOfDelimiters)
+{
+    std::string_view line = "  setoption  name Eval File ";
+    EXPECT_EQ(nextToken(line), "setoption");
+    EXPECT_EQ(nextToken(line), "name");
+    EXPECT_EQ(line, " Eval File ");
+    EXPECT_EQ(nextToken(line), "Eval");
+    EXPECT_EQ(nextToken(line), "File");
+    EXPECT_EQ(nextToken(line), "");
+    EXPECT_EQ(nextToken(line), "");
+
+    std::string_view fields = "k4,,-";
+    EXPECT_EQ(nextToken(fields, ','), "k4");
+    EXPECT_EQ(nextToken(fields, ','), "-");
+}
+
+TEST(TestTokens, TrimsAndComparesWithoutCase)
+{
+    EXPECT_EQ(trim(" \t/tmp/my net.nnue \r\n"), "/tmp/my net.nnue");
+    EXPECT_EQ(trim("   "), "");
+    EXPECT_EQ(trim(""), "");
+
+    EXPECT_TRUE(iequals("MultiPV", "multipv"));
+    EXPECT_TRUE(iequals("NNUEThreshold", "nnuethreshold"));
+    EXPECT_TRUE(iequals("", ""));
+    EXPECT_FALSE(iequals("MultiPV", "multipv "));
+    EXPECT_FALSE(iequals("Ponder", "Pondre"));
+}
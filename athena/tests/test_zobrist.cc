@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "zobrist.h"
+#include "movegen.h"
+#include "utility.h"
+
+using namespace athena;
+
+TEST(TestZobrist, IncrementalMatchesRecompute)
+{
+    Position pos;
+    fromString("classic R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bq,bp,10,gp,gk,bk,bp,10,gp,gq,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr", pos);
+
+    std::mt19937 rng(5);
+    std::vector<Move> line;
+
+    for (int step = 0; step < 500; ++step)
+    {
+        Move moves[MAX_MOVES];
+        int size = 0;
+        size += genAllNoisyMoves(pos, moves + size);
+        size += genAllQuietMoves(pos, moves + size);
+
+        if (size > 0 && (line.empty() || rng() % 5 != 0))
+        {
+            Move move = moves[rng() % size];
+            pos.makemove(move);
+            line.push_back(move);
+        }
+        else if (!line.empty())
+        {
+            pos.undomove(line.back());
+            line.pop_back();
+        }
+
+        ASSERT_EQ(pos.states.back().hash, computeHash(pos)) << "step " << step;
+    }
+}
+
+TEST(TestZobrist, TranspositionsShareKeys)
+{
+    std::string fen = "modern R 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bk,bp,10,gp,gq,bq,bp,10,gp,gk,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr";
+    Position a, b;
+    fromString(fen, a);
+    fromString(fen, b);
+
+    // Two knight moves from different knights, so either order is legal
+    Move moves[MAX_MOVES];
+    int size = genAllQuietMoves(a, moves);
+    std::vector<Move> jumps;
+    for (int i = 0; i < size; ++i)
+        if (moves[i].nature() == Jumper &&
+            (jumps.empty() || (moves[i].source() != jumps[0].source() && moves[i].target() != jumps[0].target())))
+            jumps.push_back(moves[i]);
+    ASSERT_GE(jumps.size(), 2);
+    Move first = jumps[0], second = jumps[1];
+
+    auto play = [](Position &pos, Move red)
+    {
+        pos.makemove(red);
+        for (int i = 0; i < 3; ++i)
+        {
+            Move replies[MAX_MOVES];
+            genAllQuietMoves(pos, replies);
+            pos.makemove(replies[0]);
+        }
+    };
+
+    play(a, first);
+    a.makemove(second);
+    play(b, second);
+    b.makemove(first);
+
+    EXPECT_EQ(a.states.back().hash, b.states.back().hash);
+    EXPECT_NE(a.states[1].hash, b.states[1].hash);
+}
+
+// Plays "<source><target>" moves by matching them against the generated ones
+static void playMoves(Position& pos, std::initializer_list<const char*> line)
+{
+    for (auto text : line)
+    {
+        Square source, target;
+        Piece evolve;
+        fromString(text, source, target, evolve);
+
+        Move moves[MAX_MOVES];
+        int size = 0;
+        size += genAllNoisyMoves(pos, moves + size);
+        size += genAllQuietMoves(pos, moves + size);
+
+        auto found = std::find_if(moves, moves + size, [&](Move m) { return m.source() == source && m.target() == target; });
+        ASSERT_NE(found, moves + size) << text;
+        pos.makemove(*found);
+    }
+}
+
+TEST(TestRepetition, KnightsOutAndBack)
+{
+    Position pos;
+    fromString("classic r 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bq,bp,10,gp,gk,bk,bp,10,gp,gq,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr", pos);
+
+    playMoves(pos, {"f2g4", "b6d7", "f15g13", "o6m7", "g4f2", "d7b6", "g13f15"});
+    EXPECT_EQ(pos.states.back().clock, 7);
+    EXPECT_FALSE(pos.isRepetition(100));
+
+    // Green can go back to the start, but only a search rooted before it counts
+    EXPECT_TRUE(pos.hasUpcomingRepetition(100));
+    EXPECT_FALSE(pos.hasUpcomingRepetition(7));
+
+    playMoves(pos, {"m7o6"});
+    EXPECT_EQ(pos.states[0].hash, pos.states.back().hash);
+    EXPECT_TRUE(pos.isRepetition(100));
+    EXPECT_FALSE(pos.isRepetition(8));
+
+    // A pawn move resets the clock, nothing before it can repeat
+    playMoves(pos, {"f3f4"});
+    EXPECT_EQ(pos.states.back().clock, 0);
+    EXPECT_FALSE(pos.hasUpcomingRepetition(100));
+}
+
+TEST(TestRepetition, CuckooHoldsEveryReversibleMove)
+{
+    // Both directions of a knight move hash the same change
+    auto key = ZOBRIST.piece[PieceClass(Knight, Red)][F2] ^ ZOBRIST.piece[PieceClass(Knight, Red)][G4]
+             ^ ZOBRIST.turn[Red] ^ ZOBRIST.turn[Blue];
+
+    auto entry = CUCKOO.find(key);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->a, F2);
+    EXPECT_EQ(entry->b, G4);
+    EXPECT_EQ(entry->line, Empty);
+
+    // A red piece moving on blue's turn is not a move
+    EXPECT_EQ(CUCKOO.find(key ^ ZOBRIST.turn[Red] ^ ZOBRIST.turn[Yellow]), nullptr);
+}
+
+TEST(TestElimination, TurnSkipsEliminatedPlayers)
+{
+    EXPECT_EQ(next(Red, ALL_ALIVE), Blue);
+    EXPECT_EQ(next(Red, 0b1101), Yellow);
+    EXPECT_EQ(next(Green, 0b1110), Blue);
+    EXPECT_EQ(next(Yellow, 0b0100), Yellow);
+
+    Position pos;
+    fromString("classic b 0 1111 1111 -,-,-,- rr,rn,rb,rq,rk,rb,rn,rr,rp,rp,rp,rp,rp,rp,rp,rp,8,br,bp,10,gp,gr,bn,bp,10,gp,gn,bb,bp,10,gp,gb,bq,bp,10,gp,gk,bk,bp,10,gp,gq,bb,bp,10,gp,gb,bn,bp,10,gp,gn,br,bp,10,gp,gr,8,yp,yp,yp,yp,yp,yp,yp,yp,yr,yn,yb,yk,yq,yb,yn,yr", pos);
+    auto before = pos.states.back().hash;
+
+    pos.eliminate();
+    const GameState& gs = pos.states.back();
+    EXPECT_EQ(gs.turn, Yellow);
+    EXPECT_EQ(gs.alive, 0b1101);
+    EXPECT_FALSE(gs.castle & (castleBit(Blue, KingSide) | castleBit(Blue, QueenSide)));
+    EXPECT_EQ(gs.hash, computeHash(pos));
+    EXPECT_EQ(pos.states[0].hash, before);
+
+    // A round is now three plies and lands on Red again
+    playMoves(pos, {"f15g13", "o6m7", "f2g4", "g13f15", "m7o6"});
+    EXPECT_EQ(pos.states.back().turn, Red);
+    EXPECT_EQ(pos.states.back().hash, computeHash(pos));
+
+    // Red can take its knight back to where the round began
+    EXPECT_TRUE(pos.hasUpcomingRepetition(100));
+    playMoves(pos, {"g4f2"});
+    EXPECT_EQ(pos.states.back().hash, pos.states[1].hash);
+    EXPECT_TRUE(pos.isRepetition(100));
+}